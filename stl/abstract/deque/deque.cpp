@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <cstring>
+#include <type_traits>
 
 #include "deque.hpp"
 
@@ -6,12 +8,13 @@ int DEFAULT_CAP = 10;
 
 template <typename T, class Allocator>
 Deque<T, Allocator>::Deque()
-    : buckets_(nullptr), begin_(0, 0), end_(0, 0), size_(0), cap_(0) {}
+    : buckets_(nullptr), begin_(0, 0), end_(0, 0), size_(0), cap_(0),
+      spare_count_(0) {}
 
 template <typename T, class Allocator>
 Deque<T, Allocator>::Deque(const Deque &other) : Deque() {
   this->cap_ = other.cap_;
-  buckets_ = (T **)malloc(sizeof(T *) * cap_);
+  buckets_ = this->allocate_buckets(cap_);
   for (size_t i = 0; i < other.cap_; ++i) {
     if (other.buckets_[i] == nullptr) {
       buckets_[i] = nullptr;
@@ -26,15 +29,8 @@ Deque<T, Allocator>::Deque(const Deque &other) : Deque() {
 }
 
 template <typename T, class Allocator>
-Deque<T, Allocator>::Deque(Deque &&other) noexcept {
-  this->buckets_ = other.buckets_;
-  this->begin_ = other.begin_;
-  this->end_ = other.end_;
-  this->size_ = other.size_;
-  other.buckets_ = nullptr;
-  other.begin_ = Deque<T, Allocator>::DequeIterator(0, 0);
-  other.end_ = Deque<T, Allocator>::DequeIterator(0, 0);
-  other.size_ = 0;
+Deque<T, Allocator>::Deque(Deque &&other) noexcept : Deque() {
+  this->steal(other);
 }
 
 template <typename T, class Allocator>
@@ -42,7 +38,7 @@ Deque<T, Allocator> &Deque<T, Allocator>::operator=(const Deque &other) {
   if (this != &other) {
     this->clear();
     this->cap_ = other.cap_;
-    buckets_ = (T **)malloc(sizeof(T *) * cap_);
+    buckets_ = this->allocate_buckets(cap_);
     for (size_t i = 0; i < other.cap_; ++i) {
       if (other.buckets_[i] == nullptr) {
         buckets_[i] = nullptr;
@@ -55,21 +51,16 @@ Deque<T, Allocator> &Deque<T, Allocator>::operator=(const Deque &other) {
     this->end_ = other.end_;
     this->size_ = other.size_;
   }
+  return *this;
 }
 
 template <typename T, class Allocator>
 Deque<T, Allocator> &Deque<T, Allocator>::operator=(Deque &&other) {
   if (this != &other) {
     this->clear();
-    this->buckets_ = other.buckets_;
-    this->begin_ = other.begin_;
-    this->end_ = other.end_;
-    this->size_ = other.size_;
-    other.buckets_ = nullptr;
-    other.begin_ = Deque<T, Allocator>::DequeIterator(0, 0);
-    other.end_ = Deque<T, Allocator>::DequeIterator(0, 0);
-    other.size_ = 0;
+    this->steal(other);
   }
+  return *this;
 }
 
 template <typename T, class Allocator>
@@ -92,9 +83,8 @@ T &Deque<T, Allocator>::front() {
 
 template <typename T, class Allocator>
 T &Deque<T, Allocator>::operator[](size_t pos) {
-  size_t new_ind = pos % CHUNK_SZ + this->begin_.ind_;
-  return buckets_[begin_.row_ + pos / CHUNK_SZ + new_ind / CHUNK_SZ]
-                 [new_ind % CHUNK_SZ];
+  size_t ind = begin_.ind_ + pos;
+  return buckets_[begin_.row_ + (ind >> CHUNK_SHIFT)][ind & CHUNK_MASK];
 }
 
 template <typename T, class Allocator> void Deque<T, Allocator>::clear() {
@@ -111,13 +101,44 @@ template <typename T, class Allocator> void Deque<T, Allocator>::clear() {
     }
     alloc_.deallocate(buckets_[i], CHUNK_SZ);
   }
-  free(buckets_);
+  while (spare_count_ > 0) {
+    alloc_.deallocate(spare_[--spare_count_], CHUNK_SZ);
+  }
+  if (buckets_ != nullptr) {
+    map_alloc_.deallocate(buckets_, cap_);
+  }
+  this->buckets_ = nullptr;
   this->begin_ = Deque<T, Allocator>::DequeIterator(0, 0);
   this->end_ = Deque<T, Allocator>::DequeIterator(0, 0);
   this->size_ = 0;
   this->cap_ = 0;
 }
 
+template <typename T, class Allocator>
+void Deque<T, Allocator>::shrink_to_fit() {
+  while (spare_count_ > 0) {
+    alloc_.deallocate(spare_[--spare_count_], CHUNK_SZ);
+  }
+  if (size_ == 0) {
+    this->clear();
+    return;
+  }
+  size_t first = begin_.row_;
+  size_t rows = end_.row_ + (end_.ind_ != 0) - first;
+  if (rows == cap_) {
+    return;
+  }
+  T **new_buckets = this->allocate_buckets(rows);
+  for (size_t i = 0; i < rows; ++i) {
+    new_buckets[i] = buckets_[first + i];
+  }
+  map_alloc_.deallocate(buckets_, cap_);
+  this->buckets_ = new_buckets;
+  this->begin_.row_ -= first;
+  this->end_.row_ -= first;
+  this->cap_ = rows;
+}
+
 template <typename T, class Allocator> Deque<T, Allocator>::~Deque() {
   this->clear();
 }
@@ -127,34 +148,89 @@ size_t Deque<T, Allocator>::size() const {
   return this->size_;
 }
 
+// Makes room for one more row at the requested end. Only the rows in
+// [begin_.row_, end_.row_] hold chunks, so when they fill less than half of
+// the map they are simply recentered in place; otherwise the map doubles.
 template <typename T, class Allocator>
-void Deque<T, Allocator>::restore(size_t new_cap, bool to_back) {
-  if (to_back) {
-    T** new_buckets = (T **)malloc(sizeof(T *) * new_cap);
-    for (size_t i = 0; i < cap_; ++i) {
-      new_buckets[i] = buckets_[i];
-    }
-    for (size_t i = cap_; i < new_cap; ++i) {
-      new_buckets[i] = nullptr;
+void Deque<T, Allocator>::restore(bool to_back) {
+  size_t first = begin_.row_;
+  size_t rows = end_.row_ + (end_.ind_ != 0) - first;
+  size_t new_cap = rows * 2 < cap_ ? cap_ : cap_ * 2;
+  size_t slack = new_cap - rows;
+  size_t new_first = to_back ? slack / 2 : slack - slack / 2;
+  if (new_cap == cap_) {
+    if (new_first < first) {
+      std::copy(buckets_ + first, buckets_ + first + rows,
+                buckets_ + new_first);
+    } else {
+      std::copy_backward(buckets_ + first, buckets_ + first + rows,
+                         buckets_ + new_first + rows);
     }
-    free(buckets_);
+    std::fill(buckets_, buckets_ + new_first, nullptr);
+    std::fill(buckets_ + new_first + rows, buckets_ + cap_, nullptr);
+  } else {
+    T **new_buckets = this->allocate_buckets(new_cap);
+    std::copy(buckets_ + first, buckets_ + first + rows,
+              new_buckets + new_first);
+    map_alloc_.deallocate(buckets_, cap_);
     this->buckets_ = new_buckets;
     this->cap_ = new_cap;
+  }
+  this->begin_.row_ = new_first;
+  this->end_.row_ = end_.row_ - first + new_first;
+}
+
+template <typename T, class Allocator>
+T **Deque<T, Allocator>::allocate_buckets(size_t count) {
+  T **buckets = map_alloc_.allocate(count);
+  std::fill(buckets, buckets + count, nullptr);
+  return buckets;
+}
+
+// An empty deque owns no chunks and sits in the middle of its bucket map.
+template <typename T, class Allocator>
+void Deque<T, Allocator>::init_buckets() {
+  this->cap_ = DEFAULT_CAP;
+  this->buckets_ = this->allocate_buckets(cap_);
+  this->begin_ = Deque<T, Allocator>::DequeIterator(cap_ / 2, 0);
+  this->end_ = this->begin_;
+}
+
+template <typename T, class Allocator>
+T *Deque<T, Allocator>::acquire_chunk() {
+  if (spare_count_ > 0) {
+    return spare_[--spare_count_];
+  }
+  return alloc_.allocate(CHUNK_SZ);
+}
+
+template <typename T, class Allocator>
+void Deque<T, Allocator>::release_chunk(size_t row) {
+  if (spare_count_ < SPARE_CHUNKS) {
+    spare_[spare_count_++] = buckets_[row];
   } else {
-    T** new_buckets = (T **)malloc(sizeof(T *) * new_cap);
-    for (size_t i = 0; i < new_cap - cap_; ++i) {
-      new_buckets[i] = nullptr;
-    }
-    for (size_t i = new_cap - cap_; i < new_cap; ++i) {
-      new_buckets[i] = buckets_[i + cap_ - new_cap];
-    }
-    free(buckets_);
+    alloc_.deallocate(buckets_[row], CHUNK_SZ);
+  }
+  buckets_[row] = nullptr;
+}
 
-    this->buckets_ = new_buckets;
-    this->begin_.row_ += new_cap - cap_;
-    this->end_.row_ += new_cap - cap_;
-    this->cap_ = new_cap;
+template <typename T, class Allocator>
+void Deque<T, Allocator>::steal(Deque &other) {
+  this->buckets_ = other.buckets_;
+  this->begin_ = other.begin_;
+  this->end_ = other.end_;
+  this->size_ = other.size_;
+  this->cap_ = other.cap_;
+  this->spare_count_ = other.spare_count_;
+  for (size_t i = 0; i < spare_count_; ++i) {
+    this->spare_[i] = other.spare_[i];
   }
+  other.buckets_ = nullptr;
+  other.begin_ = Deque<T, Allocator>::DequeIterator(0, 0);
+  other.end_ = Deque<T, Allocator>::DequeIterator(0, 0);
+  other.size_ = 0;
+  other.cap_ = 0;
+  other.spare_count_ = 0;
 }
 
 template <typename T, class Allocator>
@@ -171,28 +247,24 @@ template <typename T, class Allocator>
 template <class... Args>
 void Deque<T, Allocator>::emplace_back(Args &&...args) {
   if (buckets_ == nullptr) {
-    this->cap_ = DEFAULT_CAP;
-    this->buckets_ = (T **)malloc(sizeof(T *) * cap_);
-    for (size_t i = 0; i < cap_; ++i) {
-      buckets_[i] = nullptr;
-      if (i == cap_ / 2) {
-        buckets_[i] = alloc_.allocate(CHUNK_SZ);
-      }
-    }
-    this->begin_ = Deque<T, Allocator>::DequeIterator(cap_ / 2, 0);
-    this->end_ = Deque<T, Allocator>::DequeIterator(cap_ / 2, 1);
-    alloc_.construct(buckets_[cap_ / 2], std::forward<Args>(args)...);
-  } else {
-    if (end_.row_ == cap_) {
-      this->restore(cap_ * 2, true);
-    }
-    if (end_.ind_ == 0) {
-      buckets_[end_.row_] = alloc_.allocate(CHUNK_SZ);
-    }
+    this->init_buckets();
+  } else if (end_.row_ == cap_) {
+    this->restore(true);
+  }
+  bool new_chunk = end_.ind_ == 0;
+  if (new_chunk) {
+    buckets_[end_.row_] = this->acquire_chunk();
+  }
+  try {
     alloc_.construct(buckets_[end_.row_] + end_.ind_,
                      std::forward<Args>(args)...);
-    ++end_;
+  } catch (...) {
+    if (new_chunk) {
+      this->release_chunk(end_.row_);
+    }
+    throw;
   }
+  ++end_;
   ++size_;
 }
 
@@ -210,28 +282,26 @@ template <typename T, class Allocator>
 template <class... Args>
 void Deque<T, Allocator>::emplace_front(Args &&...args) {
   if (buckets_ == nullptr) {
-    this->cap_ = DEFAULT_CAP;
-    this->buckets_ = (T **)malloc(sizeof(T *) * cap_);
-    for (size_t i = 0; i < cap_; ++i) {
-      buckets_[i] = nullptr;
-      if (i == cap_ / 2) {
-        buckets_[i] = alloc_.allocate(CHUNK_SZ);
-      }
-    }
-    this->begin_ = Deque<T, Allocator>::DequeIterator(cap_ / 2, 0);
-    this->end_ = Deque<T, Allocator>::DequeIterator(cap_ / 2, 1);
-    alloc_.construct(buckets_[cap_ / 2], std::forward<Args>(args)...);
-  } else {
-    if (begin_.row_ == 0 && begin_.ind_ == 0) {
-      this->restore(cap_ * 2, false);
-    }
-    if (begin_.ind_ == 0) {
-      buckets_[begin_.row_ - 1] = alloc_.allocate(CHUNK_SZ);
-    }
-    --begin_;
-    alloc_.construct(buckets_[begin_.row_] + begin_.ind_,
+    this->init_buckets();
+  } else if (begin_.row_ == 0 && begin_.ind_ == 0) {
+    this->restore(false);
+  }
+  auto pos = begin_;
+  --pos;
+  bool new_chunk = begin_.ind_ == 0;
+  if (new_chunk) {
+    buckets_[pos.row_] = this->acquire_chunk();
+  }
+  try {
+    alloc_.construct(buckets_[pos.row_] + pos.ind_,
                      std::forward<Args>(args)...);
+  } catch (...) {
+    if (new_chunk) {
+      this->release_chunk(pos.row_);
+    }
+    throw;
   }
+  begin_ = pos;
   ++size_;
 }
 
@@ -243,6 +313,13 @@ void Deque<T, Allocator>::pop_back() {
   --end_;
   alloc_.destroy(buckets_[end_.row_] + end_.ind_);
   --size_;
+  if (size_ == 0) {
+    this->release_chunk(end_.row_);
+    this->begin_ = Deque<T, Allocator>::DequeIterator(cap_ / 2, 0);
+    this->end_ = this->begin_;
+  } else if (end_.ind_ == 0) {
+    this->release_chunk(end_.row_);
+  }
 }
 
 template <typename T, class Allocator>
@@ -251,6 +328,207 @@ void Deque<T, Allocator>::pop_front() {
     throw DequeIsEmptyException("deque is empty");
   }
   alloc_.destroy(buckets_[begin_.row_] + begin_.ind_);
-  ++begin_;
-  --size_;
-}
\ No newline at end of file
+  this->drop_front(1);
+}
+
+template <typename T, class Allocator>
+template <class InputIt>
+void Deque<T, Allocator>::push_back(InputIt first, InputIt last) {
+  while (first != last) {
+    if (buckets_ == nullptr) {
+      this->init_buckets();
+    } else if (end_.row_ == cap_) {
+      this->restore(true);
+    }
+    if (end_.ind_ == 0) {
+      buckets_[end_.row_] = this->acquire_chunk();
+    }
+    T *chunk = buckets_[end_.row_];
+    size_t ind = end_.ind_;
+    try {
+      for (; ind < CHUNK_SZ && first != last; ++ind, ++first) {
+        alloc_.construct(chunk + ind, *first);
+      }
+    } catch (...) {
+      if (ind == 0) {
+        this->release_chunk(end_.row_);
+      }
+      size_ += ind - end_.ind_;
+      end_.ind_ = ind;
+      throw;
+    }
+    size_ += ind - end_.ind_;
+    end_.ind_ = ind & CHUNK_MASK;
+    end_.row_ += ind == CHUNK_SZ;
+  }
+}
+
+template <typename T, class Allocator>
+template <class OutputIt>
+size_t Deque<T, Allocator>::pop_front_n(OutputIt out, size_t n) {
+  size_t popped = 0;
+  while (popped < n && size_ > 0) {
+    T *chunk = buckets_[begin_.row_];
+    size_t first = begin_.ind_;
+    size_t count = CHUNK_SZ - first;
+    if (count > size_) {
+      count = size_;
+    }
+    if (count > n - popped) {
+      count = n - popped;
+    }
+    size_t ind = first;
+    try {
+      for (; ind < first + count; ++ind, ++out) {
+        *out = std::move(chunk[ind]);
+        alloc_.destroy(chunk + ind);
+      }
+    } catch (...) {
+      if (ind > first) {
+        this->drop_front(ind - first);
+      }
+      throw;
+    }
+    this->drop_front(count);
+    popped += count;
+  }
+  return popped;
+}
+
+template <typename T, class Allocator>
+template <class F>
+void Deque<T, Allocator>::for_each_segment(F fn) {
+  if (size_ == 0) {
+    return;
+  }
+  size_t last_row = end_.row_ - (end_.ind_ == 0);
+  for (size_t row = begin_.row_; row <= last_row; ++row) {
+    size_t first = row == begin_.row_ ? begin_.ind_ : 0;
+    size_t last = row == end_.row_ ? end_.ind_ : CHUNK_SZ;
+    fn(buckets_[row] + first, last - first);
+  }
+}
+
+// Forgets the first count elements of the front chunk, which the caller has
+// already destroyed, and releases the chunk once it is drained.
+template <typename T, class Allocator>
+void Deque<T, Allocator>::drop_front(size_t count) {
+  size_ -= count;
+  if (size_ == 0) {
+    this->release_chunk(begin_.row_);
+    this->begin_ = Deque<T, Allocator>::DequeIterator(cap_ / 2, 0);
+    this->end_ = this->begin_;
+    return;
+  }
+  begin_.ind_ += count;
+  if (begin_.ind_ == CHUNK_SZ) {
+    this->release_chunk(begin_.row_);
+    begin_.ind_ = 0;
+    ++begin_.row_;
+  }
+}
+
+template <typename T, class Allocator>
+void Deque<T, Allocator>::insert(size_t pos, const T &val) {
+  this->emplace(pos, val);
+}
+
+template <typename T, class Allocator>
+void Deque<T, Allocator>::insert(size_t pos, T &&val) {
+  this->emplace(pos, std::move(val));
+}
+
+template <typename T, class Allocator>
+template <class... Args>
+void Deque<T, Allocator>::emplace(size_t pos, Args &&...args) {
+  if (pos > size_) {
+    throw DequeInvalidIndexException("invalid index");
+  }
+  if (pos == 0) {
+    this->emplace_front(std::forward<Args>(args)...);
+    return;
+  }
+  if (pos == size_) {
+    this->emplace_back(std::forward<Args>(args)...);
+    return;
+  }
+  // Built up front: the arguments may refer to elements about to move.
+  T val(std::forward<Args>(args)...);
+  if (pos < size_ - pos) {
+    this->emplace_front(std::move((*this)[0]));
+    this->move_elements(2, 1, pos - 1);
+  } else {
+    this->emplace_back(std::move((*this)[size_ - 1]));
+    this->move_elements(pos, pos + 1, size_ - 2 - pos);
+  }
+  (*this)[pos] = std::move(val);
+}
+
+template <typename T, class Allocator>
+void Deque<T, Allocator>::erase(size_t first, size_t last) {
+  if (first > last || last > size_) {
+    throw DequeInvalidIndexException("invalid index");
+  }
+  size_t count = last - first;
+  if (count == 0) {
+    return;
+  }
+  if (first < size_ - last) {
+    this->move_elements(0, count, first);
+    for (size_t i = 0; i < count; ++i) {
+      this->pop_front();
+    }
+  } else {
+    this->move_elements(last, first, size_ - last);
+    for (size_t i = 0; i < count; ++i) {
+      this->pop_back();
+    }
+  }
+}
+
+// Move-assigns the live elements at positions [from, from + count) onto the
+// live positions [to, to + count); the ranges may overlap. Trivially copyable
+// elements are moved as whole chunk segments with memmove.
+template <typename T, class Allocator>
+void Deque<T, Allocator>::move_elements(size_t from, size_t to,
+                                        size_t count) {
+  if (count == 0 || from == to) {
+    return;
+  }
+  if constexpr (std::is_trivially_copyable<T>::value) {
+    if (to < from) {
+      auto src = begin_ + from;
+      auto dst = begin_ + to;
+      while (count > 0) {
+        size_t step = std::min({CHUNK_SZ - src.ind_, CHUNK_SZ - dst.ind_,
+                                count});
+        std::memmove(buckets_[dst.row_] + dst.ind_,
+                     buckets_[src.row_] + src.ind_, step * sizeof(T));
+        src += step;
+        dst += step;
+        count -= step;
+      }
+    } else {
+      auto src = begin_ + (from + count);
+      auto dst = begin_ + (to + count);
+      while (count > 0) {
+        size_t src_run = src.ind_ == 0 ? CHUNK_SZ : src.ind_;
+        size_t dst_run = dst.ind_ == 0 ? CHUNK_SZ : dst.ind_;
+        size_t step = std::min({src_run, dst_run, count});
+        src -= step;
+        dst -= step;
+        std::memmove(buckets_[dst.row_] + dst.ind_,
+                     buckets_[src.row_] + src.ind_, step * sizeof(T));
+        count -= step;
+      }
+    }
+  } else if (to < from) {
+    for (size_t i = 0; i < count; ++i) {
+      (*this)[to + i] = std::move((*this)[from + i]);
+    }
+  } else {
+    for (size_t i = count; i > 0; --i) {
+      (*this)[to + i - 1] = std::move((*this)[from + i - 1]);
+    }
+  }
+}
@@ -1,13 +1,34 @@
 #pragma once
 
-#include <vector>
+#include <cstddef>
+#include <iterator>
+#include <memory>
 
 #include "exceptions.hpp"
 
-const int CHUNK_SZ = 32;
+// Every chunk targets this many bytes; the element count is rounded down to a
+// power of two so positions split into a row and an index with shifts/masks.
+const size_t CHUNK_BYTES = 4096;
+
+constexpr size_t ChunkShift(size_t elem_size) {
+  size_t count = elem_size >= CHUNK_BYTES ? 1 : CHUNK_BYTES / elem_size;
+  size_t shift = 0;
+  while ((size_t(2) << shift) <= count) {
+    ++shift;
+  }
+  return shift;
+}
+
+// Emptied chunks are kept for reuse up to this many, so a deque sliding in
+// one direction hands chunks from its front to its back without allocating.
+const size_t SPARE_CHUNKS = 2;
 
 template <typename T, class Allocator = std::allocator<T>> class Deque {
 public:
+  static constexpr size_t CHUNK_SHIFT = ChunkShift(sizeof(T));
+  static constexpr size_t CHUNK_SZ = size_t(1) << CHUNK_SHIFT;
+  static constexpr size_t CHUNK_MASK = CHUNK_SZ - 1;
+
   Deque();
 
   Deque(const Deque &other);
@@ -21,6 +42,9 @@ public:
   ~Deque();
 
 public:
+  // Random-access iterator over the chunks. The deque keeps its own begin_
+  // and end_ as bare positions; begin() and end() attach the bucket map, so
+  // iterators are invalidated by anything that reallocates the map.
   class DequeIterator {
   public:
     // NOLINTNEXTLINE
@@ -30,10 +54,16 @@ public:
     // NOLINTNEXTLINE
     using pointer_type = value_type *;
     // NOLINTNEXTLINE
+    using reference = reference_type;
+    // NOLINTNEXTLINE
+    using pointer = pointer_type;
+    // NOLINTNEXTLINE
     using difference_type = std::ptrdiff_t;
     // NOLINTNEXTLINE
     using iterator_category = std::random_access_iterator_tag;
 
+    DequeIterator() : map_(nullptr), row_(0), ind_(0) {}
+
     inline bool operator==(const DequeIterator &other) const {
       return this->row_ == other.row_ &&
              this->ind_ == other.ind_;
@@ -44,53 +74,106 @@ public:
              this->ind_ != other.ind_;
     }
 
+    inline bool operator<(const DequeIterator &other) const {
+      return this->row_ < other.row_ ||
+             (this->row_ == other.row_ && this->ind_ < other.ind_);
+    }
+
+    inline bool operator>(const DequeIterator &other) const {
+      return other < *this;
+    }
+
+    inline bool operator<=(const DequeIterator &other) const {
+      return !(other < *this);
+    }
+
+    inline bool operator>=(const DequeIterator &other) const {
+      return !(*this < other);
+    }
+
+    reference_type operator*() const { return map_[row_][ind_]; }
+
+    pointer_type operator->() const { return map_[row_] + ind_; }
+
+    reference_type operator[](difference_type n) const {
+      return *(*this + n);
+    }
+
     DequeIterator &operator++() {
-      if (ind_ == CHUNK_SZ - 1) {
-        ++row_;
-        ind_ = 0;
-      } else {
-        ++ind_;
-      }
+      ind_ = (ind_ + 1) & CHUNK_MASK;
+      row_ += ind_ == 0;
       return *this;
     }
 
     DequeIterator operator++(int) {
-      DequeIterator new_iter(row_, ind_);
+      DequeIterator new_iter(*this);
       ++(*this);
       return new_iter;
     };
 
     DequeIterator &operator--() {
-      if (ind_ == 0) {
-        --row_;
-        ind_ = CHUNK_SZ - 1;
-      } else {
-        --ind_;
-      }
+      row_ -= ind_ == 0;
+      ind_ = (ind_ - 1) & CHUNK_MASK;
       return *this;
     }
 
     DequeIterator operator--(int) {
-      DequeIterator new_iter(row_, ind_);
+      DequeIterator new_iter(*this);
       --(*this);
       return new_iter;
     };
 
+    DequeIterator &operator+=(difference_type n) {
+      // Arithmetic shift floors, so stepping back across rows works too.
+      difference_type pos = static_cast<difference_type>(ind_) + n;
+      row_ += pos >> static_cast<difference_type>(CHUNK_SHIFT);
+      ind_ = static_cast<size_t>(pos) & CHUNK_MASK;
+      return *this;
+    }
+
+    DequeIterator &operator-=(difference_type n) { return *this += -n; }
+
+    DequeIterator operator+(difference_type n) const {
+      DequeIterator new_iter(*this);
+      return new_iter += n;
+    }
+
+    friend DequeIterator operator+(difference_type n,
+                                   const DequeIterator &it) {
+      return it + n;
+    }
+
+    DequeIterator operator-(difference_type n) const {
+      DequeIterator new_iter(*this);
+      return new_iter -= n;
+    }
+
+    difference_type operator-(const DequeIterator &other) const {
+      return static_cast<difference_type>((row_ - other.row_) * CHUNK_SZ) +
+             static_cast<difference_type>(ind_) -
+             static_cast<difference_type>(other.ind_);
+    }
+
   private:
-    friend class Deque<T>;
+    friend class Deque;
     explicit DequeIterator(size_t row_,
                            size_t ind_)
-        : row_(row_),
+        : map_(nullptr),
+          row_(row_),
           ind_(ind_) {}
 
+    DequeIterator(T **map, const DequeIterator &pos)
+        : map_(map), row_(pos.row_), ind_(pos.ind_) {}
+
   private:
+    T **map_;
     size_t row_;
     size_t ind_;
   };
 
-  DequeIterator begin() const { return this->begin_; }
+  DequeIterator begin() const { return DequeIterator(buckets_, begin_); }
 
-  DequeIterator end() const { return this->end_; }
+  DequeIterator end() const { return DequeIterator(buckets_, end_); }
 
   void push_back(const T &);
 
@@ -98,6 +181,10 @@ public:
 
   template <class... Args> void emplace_back(Args &&...);
 
+  // Appends [first, last), filling one chunk at a time. If an element throws,
+  // the ones appended before it stay.
+  template <class InputIt> void push_back(InputIt first, InputIt last);
+
   void push_front(const T &);
 
   void push_front(T &&);
@@ -108,18 +195,55 @@ public:
 
   void pop_front();
 
+  // Inserts before position pos, shifting whichever side of pos is shorter.
+  void insert(size_t pos, const T &);
+
+  void insert(size_t pos, T &&);
+
+  template <class... Args> void emplace(size_t pos, Args &&...);
+
+  // Erases positions [first, last), closing the gap from the shorter side.
+  void erase(size_t first, size_t last);
+
+  // Moves up to n front elements to out and pops them, one chunk at a time.
+  // Returns how many were popped.
+  template <class OutputIt> size_t pop_front_n(OutputIt out, size_t n);
+
   T &back();
 
   T &front();
 
   T &operator[](size_t);
 
+  // Calls fn(ptr, count) for every contiguous run of elements, front to back.
+  template <class F> void for_each_segment(F fn);
+
   void clear();
 
+  // Frees spare chunks and shrinks the bucket map to the rows in use.
+  void shrink_to_fit();
+
   size_t size() const;
 
 private:
-  void restore(size_t, bool);
+  using MapAllocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<T *>;
+
+  void restore(bool);
+
+  T **allocate_buckets(size_t);
+
+  void init_buckets();
+
+  T *acquire_chunk();
+
+  void release_chunk(size_t);
+
+  void steal(Deque &);
+
+  void drop_front(size_t);
+
+  void move_elements(size_t, size_t, size_t);
 
 private:
   T **buckets_;
@@ -127,5 +251,8 @@ private:
   DequeIterator end_;
   size_t size_;
   size_t cap_;
+  T *spare_[SPARE_CHUNKS];
+  size_t spare_count_;
   Allocator alloc_;
+  MapAllocator map_alloc_;
 };
\ No newline at end of file
@@ -10,4 +10,15 @@ public:
 
 private:
   std::string_view error_message_;
-};
\ No newline at end of file
+};
+
+class DequeInvalidIndexException : std::exception {
+public:
+  explicit DequeInvalidIndexException(const std::string &text)
+      : error_message_(text) {}
+
+  const char *what() const noexcept override { return error_message_.data(); }
+
+private:
+  std::string_view error_message_;
+};
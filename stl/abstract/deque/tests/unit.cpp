@@ -1,3 +1,9 @@
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
 #include "../deque.cpp"
 
@@ -93,6 +99,376 @@ TEST(DequeTests, PopFront) {
   ASSERT_EQ(deq.size(), 0);
 }
 
+struct BigStruct {
+  char payload[5000];
+  int value;
+};
+
+TEST(DequeTests, ChunkSizeFollowsByteBudget) {
+  static_assert(Deque<char>::CHUNK_SZ == 4096);
+  static_assert(Deque<int>::CHUNK_SZ == 1024);
+  static_assert(Deque<int>::CHUNK_MASK == 1023);
+  static_assert(Deque<char[3]>::CHUNK_SZ == 1024);
+  static_assert(Deque<BigStruct>::CHUNK_SZ == 1);
+  ASSERT_EQ(Deque<int>::CHUNK_SZ << Deque<int>::CHUNK_SHIFT, 1024 * 1024);
+}
+
+TEST(DequeTests, IndexAcrossChunks) {
+  Deque<int> deq;
+  for (int i = 0; i < 5000; ++i) {
+    deq.push_back(i);
+    deq.push_front(-i - 1);
+  }
+  ASSERT_EQ(deq.size(), 10000);
+  for (size_t i = 0; i < deq.size(); ++i) {
+    ASSERT_EQ(deq[i], static_cast<int>(i) - 5000);
+  }
+}
+
+TEST(DequeTests, SingleElementChunks) {
+  Deque<BigStruct> deq;
+  for (int i = 0; i < 50; ++i) {
+    BigStruct item{};
+    item.value = i;
+    if (i % 2 == 0) {
+      deq.push_back(item);
+    } else {
+      deq.push_front(item);
+    }
+  }
+  ASSERT_EQ(deq.size(), 50);
+  ASSERT_EQ(deq.front().value, 49);
+  ASSERT_EQ(deq.back().value, 48);
+  ASSERT_EQ(deq[25].value, 0);
+  size_t count = 0;
+  for (auto it = deq.begin(); it != deq.end(); ++it) {
+    ++count;
+  }
+  ASSERT_EQ(count, 50);
+}
+
+template <typename T> struct CountingAllocator : std::allocator<T> {
+  template <typename U> struct rebind {
+    using other = CountingAllocator<U>;
+  };
+
+  static inline size_t allocated = 0;
+  static inline size_t live = 0;
+
+  T *allocate(size_t count) {
+    ++allocated;
+    ++live;
+    return std::allocator<T>::allocate(count);
+  }
+
+  void deallocate(T *ptr, size_t count) {
+    --live;
+    std::allocator<T>::deallocate(ptr, count);
+  }
+};
+
+TEST(DequeTests, FifoRecyclesChunks) {
+  using Alloc = CountingAllocator<int>;
+  Alloc::allocated = 0;
+  {
+    Deque<int, Alloc> deq;
+    const size_t chunk = Deque<int, Alloc>::CHUNK_SZ;
+    for (size_t i = 0; i < chunk; ++i) {
+      deq.push_back(i);
+    }
+    size_t warmup = Alloc::allocated;
+    for (size_t i = 0; i < 100 * chunk; ++i) {
+      deq.push_back(chunk + i);
+      ASSERT_EQ(deq.front(), static_cast<int>(i));
+      deq.pop_front();
+    }
+    ASSERT_EQ(deq.size(), chunk);
+    ASSERT_LE(Alloc::allocated, warmup + SPARE_CHUNKS);
+    ASSERT_LE(Alloc::live, 2 + SPARE_CHUNKS);
+  }
+  ASSERT_EQ(Alloc::live, 0);
+}
+
+TEST(DequeTests, PopBackReleasesChunks) {
+  using Alloc = CountingAllocator<int>;
+  Alloc::allocated = 0;
+  Deque<int, Alloc> deq;
+  const size_t chunk = Deque<int, Alloc>::CHUNK_SZ;
+  for (int round = 0; round < 10; ++round) {
+    for (size_t i = 0; i < SPARE_CHUNKS * chunk; ++i) {
+      deq.push_back(i);
+    }
+    for (size_t i = 0; i < SPARE_CHUNKS * chunk; ++i) {
+      deq.pop_back();
+    }
+  }
+  ASSERT_EQ(deq.size(), 0);
+  ASSERT_EQ(Alloc::allocated, SPARE_CHUNKS);
+  ASSERT_EQ(Alloc::live, SPARE_CHUNKS);
+}
+
+TEST(DequeTests, ShrinkToFit) {
+  using Alloc = CountingAllocator<int>;
+  Deque<int, Alloc> deq;
+  const size_t chunk = Deque<int, Alloc>::CHUNK_SZ;
+  for (size_t i = 0; i < 8 * chunk; ++i) {
+    deq.push_back(i);
+  }
+  for (size_t i = 0; i < 6 * chunk; ++i) {
+    deq.pop_front();
+  }
+  deq.shrink_to_fit();
+  ASSERT_EQ(Alloc::live, 2);
+  ASSERT_EQ(deq.size(), 2 * chunk);
+  for (size_t i = 0; i < deq.size(); ++i) {
+    ASSERT_EQ(deq[i], static_cast<int>(6 * chunk + i));
+  }
+  deq.push_front(-1);
+  deq.push_back(-2);
+  ASSERT_EQ(deq.front(), -1);
+  ASSERT_EQ(deq.back(), -2);
+  while (deq.size() > 0) {
+    deq.pop_back();
+  }
+  deq.shrink_to_fit();
+  ASSERT_EQ(Alloc::live, 0);
+  deq.push_back(5);
+  ASSERT_EQ(deq.front(), 5);
+}
+
+TEST(DequeTests, MoveConstructor) {
+  Deque<int> deq;
+  for (int i = 0; i < 3000; ++i) {
+    deq.push_back(i);
+  }
+  Deque<int> moved(std::move(deq));
+  ASSERT_EQ(deq.size(), 0);
+  ASSERT_EQ(moved.size(), 3000);
+  moved.push_front(-1);
+  ASSERT_EQ(moved[0], -1);
+  ASSERT_EQ(moved[3000], 2999);
+  deq = std::move(moved);
+  ASSERT_EQ(deq.size(), 3001);
+  deq.push_back(1);
+}
+
+TEST(DequeTests, SlidingWindowKeepsBucketMap) {
+  using MapAlloc = CountingAllocator<int *>;
+  MapAlloc::allocated = 0;
+  {
+    Deque<int, CountingAllocator<int>> deq;
+    const size_t chunk = Deque<int, CountingAllocator<int>>::CHUNK_SZ;
+    for (size_t i = 0; i < 3 * chunk; ++i) {
+      deq.push_back(i);
+    }
+    ASSERT_EQ(MapAlloc::allocated, 1);
+    for (size_t i = 0; i < 1000 * chunk; ++i) {
+      deq.push_back(3 * chunk + i);
+      ASSERT_EQ(deq.front(), static_cast<int>(i));
+      deq.pop_front();
+    }
+    ASSERT_EQ(MapAlloc::allocated, 1);
+    for (size_t i = 0; i < 1000 * chunk; ++i) {
+      deq.push_front(-static_cast<int>(i));
+      deq.pop_back();
+    }
+    ASSERT_EQ(MapAlloc::allocated, 1);
+    ASSERT_EQ(deq.size(), 3 * chunk);
+  }
+  ASSERT_EQ(MapAlloc::live, 0);
+}
+
+TEST(DequeTests, BucketMapGrowsWhenFull) {
+  Deque<int> deq;
+  for (int i = 0; i < 100000; ++i) {
+    if (i % 2 == 0) {
+      deq.push_back(i);
+    } else {
+      deq.push_front(i);
+    }
+  }
+  for (int i = 0; i < 100000; i += 2) {
+    ASSERT_EQ(deq.back(), 99998 - i);
+    deq.pop_back();
+  }
+  ASSERT_EQ(deq.front(), 99999);
+  ASSERT_EQ(deq.size(), 50000);
+}
+
+TEST(DequeTests, RandomAccessIterator) {
+  Deque<int> deq;
+  const int count = 5000;
+  for (int i = 0; i < count; ++i) {
+    deq.push_back(i);
+    deq.push_front(-i - 1);
+  }
+  auto first = deq.begin();
+  auto last = deq.end();
+  ASSERT_EQ(last - first, 2 * count);
+  ASSERT_EQ(*first, -count);
+  ASSERT_EQ(first[count], 0);
+  ASSERT_EQ(*(last - 1), count - 1);
+  auto it = first + 3000;
+  ASSERT_EQ(*it, 3000 - count);
+  it -= 2500;
+  ASSERT_EQ(*it, 500 - count);
+  it += 7777;
+  ASSERT_EQ(*it, 8277 - count);
+  ASSERT_EQ(it - first, 8277);
+  ASSERT_EQ(first - it, -8277);
+  ASSERT_TRUE(first < it);
+  ASSERT_TRUE(it <= last);
+  ASSERT_FALSE(it > last);
+  ASSERT_TRUE(2 + first == first + 2);
+}
+
+TEST(DequeTests, WorksWithAlgorithms) {
+  Deque<int> deq;
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<int> value_dist(0, 999);
+  for (int i = 0; i < 10000; ++i) {
+    deq.push_front(value_dist(gen));
+  }
+  std::sort(deq.begin(), deq.end());
+  ASSERT_TRUE(std::is_sorted(deq.begin(), deq.end()));
+  auto pos = std::lower_bound(deq.begin(), deq.end(), 500);
+  ASSERT_TRUE(pos == deq.end() || *pos >= 500);
+  ASSERT_TRUE(pos == deq.begin() || *(pos - 1) < 500);
+}
+
+TEST(DequeTests, ForEachSegment) {
+  Deque<int> deq;
+  const size_t chunk = Deque<int>::CHUNK_SZ;
+  deq.for_each_segment([](int *, size_t) { FAIL(); });
+  for (size_t i = 0; i < 3 * chunk; ++i) {
+    deq.push_back(1);
+  }
+  for (size_t i = 0; i < 5; ++i) {
+    deq.push_front(1);
+  }
+  size_t segments = 0;
+  size_t total = 0;
+  long long sum = 0;
+  deq.for_each_segment([&](int *ptr, size_t count) {
+    ++segments;
+    total += count;
+    for (size_t i = 0; i < count; ++i) {
+      sum += ptr[i];
+    }
+  });
+  ASSERT_EQ(segments, 4);
+  ASSERT_EQ(total, deq.size());
+  ASSERT_EQ(sum, static_cast<long long>(deq.size()));
+}
+
+TEST(DequeTests, BulkPushAndPop) {
+  Deque<int> deq;
+  std::vector<int> input(10000);
+  for (int i = 0; i < 10000; ++i) {
+    input[i] = i;
+  }
+  deq.push_back(7);
+  deq.pop_front();
+  deq.push_back(input.data(), input.data() + input.size());
+  deq.push_back(input.data(), input.data());
+  ASSERT_EQ(deq.size(), 10000);
+  for (int i = 0; i < 10000; ++i) {
+    ASSERT_EQ(deq[i], i);
+  }
+  std::vector<int> output(3000);
+  int expected = 0;
+  while (true) {
+    size_t popped = deq.pop_front_n(output.data(), output.size());
+    if (popped == 0) {
+      break;
+    }
+    for (size_t i = 0; i < popped; ++i) {
+      ASSERT_EQ(output[i], expected++);
+    }
+  }
+  ASSERT_EQ(expected, 10000);
+  ASSERT_EQ(deq.size(), 0);
+  deq.push_back(input.data(), input.data() + 10);
+  ASSERT_EQ(deq.front(), 0);
+  ASSERT_EQ(deq.back(), 9);
+}
+
+TEST(DequeTests, BulkOpsReleaseChunks) {
+  using Alloc = CountingAllocator<int>;
+  Alloc::allocated = 0;
+  {
+    Deque<int, Alloc> deq;
+    const size_t chunk = Deque<int, Alloc>::CHUNK_SZ;
+    std::vector<int> input(chunk * 10, 1);
+    std::vector<int> output(chunk * 10);
+    for (int round = 0; round < 20; ++round) {
+      deq.push_back(input.begin(), input.end());
+      ASSERT_EQ(deq.pop_front_n(output.begin(), output.size()),
+                output.size());
+      ASSERT_EQ(Alloc::live, SPARE_CHUNKS);
+    }
+  }
+  ASSERT_EQ(Alloc::live, 0);
+}
+
+template <typename T, typename Make> void CheckMiddleOps(Make make) {
+  Deque<T> deq;
+  std::deque<T> model;
+  std::mt19937 gen(17);
+  std::uniform_int_distribution<int> op_dist(0, 3);
+  for (int step = 0; step < 6000; ++step) {
+    int op = op_dist(gen);
+    size_t pos = gen() % (model.size() + 1);
+    if (op < 2 || model.size() < 10) {
+      T val = make(step);
+      deq.insert(pos, val);
+      model.insert(model.begin() + pos, val);
+    } else if (op == 2) {
+      size_t last = pos + gen() % 700;
+      last = std::min(last, model.size());
+      deq.erase(pos, last);
+      model.erase(model.begin() + pos, model.begin() + last);
+    } else {
+      deq.emplace(pos, make(-step));
+      model.insert(model.begin() + pos, make(-step));
+    }
+    ASSERT_EQ(deq.size(), model.size());
+  }
+  for (size_t i = 0; i < model.size(); ++i) {
+    ASSERT_EQ(deq[i], model[i]);
+  }
+}
+
+TEST(DequeTests, MiddleInsertEraseTrivial) {
+  CheckMiddleOps<int>([](int i) { return i; });
+}
+
+TEST(DequeTests, MiddleInsertEraseNonTrivial) {
+  CheckMiddleOps<std::string>([](int i) { return std::to_string(i); });
+}
+
+TEST(DequeTests, InsertAliasingElement) {
+  Deque<std::string> deq;
+  for (int i = 0; i < 10; ++i) {
+    deq.push_back(std::to_string(i));
+  }
+  deq.insert(3, deq[0]);
+  deq.insert(8, deq[10]);
+  ASSERT_EQ(deq[3], "0");
+  ASSERT_EQ(deq[8], "9");
+  ASSERT_EQ(deq.size(), 12);
+}
+
+TEST(DequeTests, MiddleOpsInvalidIndex) {
+  Deque<int> deq;
+  deq.push_back(1);
+  EXPECT_THROW({ deq.insert(2, 5); }, DequeInvalidIndexException);
+  EXPECT_THROW({ deq.erase(1, 0); }, DequeInvalidIndexException);
+  EXPECT_THROW({ deq.erase(0, 2); }, DequeInvalidIndexException);
+  deq.erase(0, 1);
+  ASSERT_EQ(deq.size(), 0);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <exception>
+#include <string>
+
+class HiveIsEmptyException : std::exception {
+public:
+  explicit HiveIsEmptyException(const std::string &text)
+      : error_message_(text) {}
+
+  const char *what() const noexcept override { return error_message_.data(); }
+
+private:
+  std::string_view error_message_;
+};
@@ -0,0 +1,512 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <utility>
+
+#include "allocator.hpp"
+#include "exceptions.hpp"
+
+const size_t HIVE_MIN_BLOCK = 8;
+const size_t HIVE_MAX_BLOCK = 8192;
+
+// Bucket container with stable element addresses. Elements live in a chain of
+// growing blocks; erasure only marks the slot in the block's skip-field, so
+// nothing is ever moved, and later insertions reuse the erased slots.
+//
+// Skip-field: 0 marks a live slot. A run of erased slots stores its length in
+// its first and last entries, so iteration jumps over the whole run at once.
+// The first slot of every run also keeps the links of the block's free-run
+// list, which is how insertion finds a reusable slot in O(1).
+template <typename T, template <typename> class Allocator = allocator>
+class Hive {
+  using skip_type = uint16_t;
+
+  static constexpr skip_type NO_RUN = std::numeric_limits<skip_type>::max();
+
+  static_assert(HIVE_MAX_BLOCK < NO_RUN,
+                "block capacity must fit into the skip-field type");
+
+  struct FreeLinks {
+    skip_type prev_;
+    skip_type next_;
+  };
+
+  struct Slot {
+    alignas(alignof(T) > alignof(FreeLinks) ? alignof(T) : alignof(FreeLinks))
+        unsigned char bytes_[sizeof(T) > sizeof(FreeLinks) ? sizeof(T)
+                                                           : sizeof(FreeLinks)];
+  };
+
+  struct Block {
+    Slot *slots_;
+    skip_type *skip_;
+    size_t capacity_;
+    // Slots [0, end_) have been handed out at least once.
+    size_t end_;
+    size_t size_;
+    skip_type free_head_;
+    Block *prev_;
+    Block *next_;
+    // Links in the list of blocks that have erased slots to reuse.
+    Block *prev_free_;
+    Block *next_free_;
+  };
+
+public:
+  class HiveIterator {
+  public:
+    // NOLINTNEXTLINE
+    using value_type = T;
+    // NOLINTNEXTLINE
+    using reference_type = value_type &;
+    // NOLINTNEXTLINE
+    using pointer_type = value_type *;
+    // NOLINTNEXTLINE
+    using difference_type = std::ptrdiff_t;
+    // NOLINTNEXTLINE
+    using iterator_category = std::bidirectional_iterator_tag;
+
+    inline bool operator==(const HiveIterator &other) const {
+      return block_ == other.block_ && index_ == other.index_;
+    }
+
+    inline bool operator!=(const HiveIterator &other) const {
+      return block_ != other.block_ || index_ != other.index_;
+    }
+
+    inline reference_type operator*() const { return *Element(block_, index_); }
+
+    inline pointer_type operator->() const { return Element(block_, index_); }
+
+    HiveIterator &operator++() {
+      size_t next = index_ + 1;
+      if (next < block_->end_) {
+        next += block_->skip_[next];
+      }
+      if (next >= block_->end_ && block_->next_ != nullptr) {
+        block_ = block_->next_;
+        next = block_->skip_[0];
+      }
+      index_ = next;
+      return *this;
+    }
+
+    HiveIterator operator++(int) {
+      HiveIterator new_iter(block_, index_);
+      ++(*this);
+      return new_iter;
+    }
+
+    HiveIterator &operator--() {
+      // The previous live slot is in the previous block when this one is the
+      // first slot or is preceded by an erased run reaching slot 0.
+      if (index_ == 0 || block_->skip_[index_ - 1] == index_) {
+        block_ = block_->prev_;
+        index_ = block_->end_;
+      }
+      size_t prev = index_ - 1;
+      index_ = prev - block_->skip_[prev];
+      return *this;
+    }
+
+    HiveIterator operator--(int) {
+      HiveIterator new_iter(block_, index_);
+      --(*this);
+      return new_iter;
+    }
+
+  private:
+    friend class Hive;
+    explicit HiveIterator(Block *block, size_t index)
+        : block_(block), index_(index) {}
+
+  private:
+    Block *block_;
+    size_t index_;
+  };
+
+public:
+  Hive()
+      : head_(nullptr), tail_(nullptr), free_blocks_(nullptr), spare_(nullptr),
+        size_(0), capacity_(0) {}
+
+  Hive(const std::initializer_list<T> &values) : Hive() {
+    for (const T &value : values) {
+      insert(value);
+    }
+  }
+
+  Hive(const Hive &other) : Hive() {
+    for (const T &value : other) {
+      insert(value);
+    }
+  }
+
+  Hive(Hive &&other) noexcept : Hive() { Steal(other); }
+
+  Hive &operator=(const Hive &other) {
+    if (this != &other) {
+      clear();
+      for (const T &value : other) {
+        insert(value);
+      }
+    }
+    return *this;
+  }
+
+  Hive &operator=(Hive &&other) noexcept {
+    if (this != &other) {
+      Release();
+      Steal(other);
+    }
+    return *this;
+  }
+
+  ~Hive() { Release(); }
+
+  HiveIterator begin() const {
+    if (size_ == 0) {
+      return end();
+    }
+    return HiveIterator(head_, head_->skip_[0]);
+  }
+
+  HiveIterator end() const {
+    if (tail_ == nullptr) {
+      return HiveIterator(nullptr, 0);
+    }
+    return HiveIterator(tail_, tail_->end_);
+  }
+
+  HiveIterator insert(const T &value) { return emplace(value); }
+
+  HiveIterator insert(T &&value) { return emplace(std::move(value)); }
+
+  template <class... Args> HiveIterator emplace(Args &&...args) {
+    if (free_blocks_ != nullptr) {
+      return EmplaceIntoRun(free_blocks_, std::forward<Args>(args)...);
+    }
+    Block *block = tail_;
+    if (block == nullptr || block->end_ == block->capacity_) {
+      block = AddBlock();
+    }
+    size_t index = block->end_;
+    try {
+      alloc_.construct(Element(block, index), std::forward<Args>(args)...);
+    } catch (...) {
+      if (block->size_ == 0) {
+        RemoveBlock(block);
+      }
+      throw;
+    }
+    block->skip_[index] = 0;
+    ++block->end_;
+    ++block->size_;
+    ++size_;
+    return HiveIterator(block, index);
+  }
+
+  // Returns the iterator following the erased element.
+  HiveIterator erase(HiveIterator pos) {
+    if (size_ == 0) {
+      throw HiveIsEmptyException("hive is empty");
+    }
+    HiveIterator next = pos;
+    ++next;
+    Block *block = pos.block_;
+    size_t index = pos.index_;
+    alloc_.destroy(Element(block, index));
+    --size_;
+    if (--block->size_ == 0) {
+      bool was_tail = block == tail_;
+      RemoveBlock(block);
+      return was_tail ? end() : next;
+    }
+    MarkErased(block, index);
+    return next;
+  }
+
+  // Finds the element stored at `ptr`, end() if it doesn't belong to the hive.
+  HiveIterator get_iterator(const T *ptr) const {
+    const Slot *slot = reinterpret_cast<const Slot *>(ptr);
+    for (Block *block = head_; block != nullptr; block = block->next_) {
+      if (slot >= block->slots_ && slot < block->slots_ + block->end_) {
+        size_t index = slot - block->slots_;
+        if (block->skip_[index] == 0) {
+          return HiveIterator(block, index);
+        }
+        break;
+      }
+    }
+    return end();
+  }
+
+  void clear() {
+    Block *block = head_;
+    while (block != nullptr) {
+      Block *next = block->next_;
+      DestroyElements(block);
+      if (spare_ == nullptr) {
+        ResetBlock(block);
+        spare_ = block;
+      } else {
+        capacity_ -= block->capacity_;
+        FreeBlock(block);
+      }
+      block = next;
+    }
+    head_ = nullptr;
+    tail_ = nullptr;
+    free_blocks_ = nullptr;
+    size_ = 0;
+  }
+
+  inline bool is_empty() const noexcept { return size_ == 0; }
+
+  inline size_t size() const noexcept { return size_; }
+
+  inline size_t capacity() const noexcept { return capacity_; }
+
+private:
+  static T *Element(Block *block, size_t index) {
+    return std::launder(reinterpret_cast<T *>(block->slots_[index].bytes_));
+  }
+
+  static FreeLinks &Links(Block *block, size_t index) {
+    return *std::launder(
+        reinterpret_cast<FreeLinks *>(block->slots_[index].bytes_));
+  }
+
+  template <class... Args>
+  HiveIterator EmplaceIntoRun(Block *block, Args &&...args) {
+    size_t index = block->free_head_;
+    size_t length = block->skip_[index];
+    FreeLinks links = Links(block, index);
+    try {
+      alloc_.construct(Element(block, index), std::forward<Args>(args)...);
+    } catch (...) {
+      Links(block, index) = links;
+      throw;
+    }
+    // The run gives up its first slot: either it disappears or it starts one
+    // slot later and takes over the free-list links.
+    if (length == 1) {
+      UnlinkRun(block, links);
+    } else {
+      block->skip_[index + 1] = length - 1;
+      block->skip_[index + length - 1] = length - 1;
+      MoveRun(block, index + 1, links);
+    }
+    block->skip_[index] = 0;
+    ++block->size_;
+    ++size_;
+    return HiveIterator(block, index);
+  }
+
+  void MarkErased(Block *block, size_t index) {
+    size_t left = index > 0 ? block->skip_[index - 1] : 0;
+    size_t right = index + 1 < block->end_ ? block->skip_[index + 1] : 0;
+    if (left == 0 && right == 0) {
+      block->skip_[index] = 1;
+      PushRun(block, index);
+    } else if (right == 0) {
+      size_t length = left + 1;
+      block->skip_[index - left] = length;
+      block->skip_[index] = length;
+    } else if (left == 0) {
+      size_t length = right + 1;
+      FreeLinks links = Links(block, index + 1);
+      block->skip_[index] = length;
+      block->skip_[index + right] = length;
+      MoveRun(block, index, links);
+    } else {
+      size_t length = left + right + 1;
+      UnlinkRun(block, Links(block, index + 1));
+      block->skip_[index - left] = length;
+      block->skip_[index] = length;
+      block->skip_[index + right] = length;
+    }
+  }
+
+  void PushRun(Block *block, size_t index) {
+    FreeLinks &links = Links(block, index);
+    links.prev_ = NO_RUN;
+    links.next_ = block->free_head_;
+    if (block->free_head_ == NO_RUN) {
+      LinkFreeBlock(block);
+    } else {
+      Links(block, block->free_head_).prev_ = index;
+    }
+    block->free_head_ = index;
+  }
+
+  // Moves the free-list entry of a run to `index`, its new first slot.
+  void MoveRun(Block *block, size_t index, const FreeLinks &links) {
+    Links(block, index) = links;
+    if (links.prev_ == NO_RUN) {
+      block->free_head_ = index;
+    } else {
+      Links(block, links.prev_).next_ = index;
+    }
+    if (links.next_ != NO_RUN) {
+      Links(block, links.next_).prev_ = index;
+    }
+  }
+
+  void UnlinkRun(Block *block, const FreeLinks &links) {
+    if (links.prev_ == NO_RUN) {
+      block->free_head_ = links.next_;
+    } else {
+      Links(block, links.prev_).next_ = links.next_;
+    }
+    if (links.next_ != NO_RUN) {
+      Links(block, links.next_).prev_ = links.prev_;
+    }
+    if (block->free_head_ == NO_RUN) {
+      UnlinkFreeBlock(block);
+    }
+  }
+
+  void LinkFreeBlock(Block *block) {
+    block->prev_free_ = nullptr;
+    block->next_free_ = free_blocks_;
+    if (free_blocks_ != nullptr) {
+      free_blocks_->prev_free_ = block;
+    }
+    free_blocks_ = block;
+  }
+
+  void UnlinkFreeBlock(Block *block) {
+    if (block->prev_free_ == nullptr) {
+      free_blocks_ = block->next_free_;
+    } else {
+      block->prev_free_->next_free_ = block->next_free_;
+    }
+    if (block->next_free_ != nullptr) {
+      block->next_free_->prev_free_ = block->prev_free_;
+    }
+    block->prev_free_ = nullptr;
+    block->next_free_ = nullptr;
+  }
+
+  Block *AddBlock() {
+    Block *block = spare_;
+    spare_ = nullptr;
+    if (block == nullptr) {
+      size_t capacity = size_;
+      if (capacity < HIVE_MIN_BLOCK) {
+        capacity = HIVE_MIN_BLOCK;
+      } else if (capacity > HIVE_MAX_BLOCK) {
+        capacity = HIVE_MAX_BLOCK;
+      }
+      block = block_alloc_.allocate(1);
+      block->slots_ = slot_alloc_.allocate(capacity);
+      block->skip_ = skip_alloc_.allocate(capacity);
+      block->capacity_ = capacity;
+      capacity_ += capacity;
+      ResetBlock(block);
+    }
+    block->prev_ = tail_;
+    block->next_ = nullptr;
+    if (tail_ == nullptr) {
+      head_ = block;
+    } else {
+      tail_->next_ = block;
+    }
+    tail_ = block;
+    return block;
+  }
+
+  // Unlinks an empty block, keeping one around to absorb insert/erase
+  // oscillation on a block boundary.
+  void RemoveBlock(Block *block) {
+    if (block->free_head_ != NO_RUN) {
+      UnlinkFreeBlock(block);
+    }
+    if (block->prev_ == nullptr) {
+      head_ = block->next_;
+    } else {
+      block->prev_->next_ = block->next_;
+    }
+    if (block->next_ == nullptr) {
+      tail_ = block->prev_;
+    } else {
+      block->next_->prev_ = block->prev_;
+    }
+    if (spare_ == nullptr) {
+      ResetBlock(block);
+      spare_ = block;
+    } else {
+      capacity_ -= block->capacity_;
+      FreeBlock(block);
+    }
+  }
+
+  static void ResetBlock(Block *block) {
+    block->end_ = 0;
+    block->size_ = 0;
+    block->free_head_ = NO_RUN;
+    block->prev_ = nullptr;
+    block->next_ = nullptr;
+    block->prev_free_ = nullptr;
+    block->next_free_ = nullptr;
+  }
+
+  void FreeBlock(Block *block) {
+    slot_alloc_.deallocate(block->slots_, block->capacity_);
+    skip_alloc_.deallocate(block->skip_, block->capacity_);
+    block_alloc_.deallocate(block, 1);
+  }
+
+  void DestroyElements(Block *block) {
+    size_t index = block->skip_[0];
+    while (index < block->end_) {
+      alloc_.destroy(Element(block, index));
+      ++index;
+      if (index < block->end_) {
+        index += block->skip_[index];
+      }
+    }
+  }
+
+  void Release() {
+    clear();
+    if (spare_ != nullptr) {
+      FreeBlock(spare_);
+      spare_ = nullptr;
+    }
+    capacity_ = 0;
+  }
+
+  void Steal(Hive &other) {
+    head_ = other.head_;
+    tail_ = other.tail_;
+    free_blocks_ = other.free_blocks_;
+    spare_ = other.spare_;
+    size_ = other.size_;
+    capacity_ = other.capacity_;
+    other.head_ = nullptr;
+    other.tail_ = nullptr;
+    other.free_blocks_ = nullptr;
+    other.spare_ = nullptr;
+    other.size_ = 0;
+    other.capacity_ = 0;
+  }
+
+private:
+  Block *head_;
+  Block *tail_;
+  Block *free_blocks_;
+  Block *spare_;
+  size_t size_;
+  size_t capacity_;
+  Allocator<T> alloc_;
+  Allocator<Slot> slot_alloc_;
+  Allocator<skip_type> skip_alloc_;
+  Allocator<Block> block_alloc_;
+};
@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../hive.hpp"
+
+TEST(HiveTests, DefaultConstructor) {
+  Hive<int> hive;
+  ASSERT_EQ(hive.size(), 0);
+  ASSERT_TRUE(hive.is_empty());
+  ASSERT_TRUE(hive.begin() == hive.end());
+}
+
+TEST(HiveTests, Insert) {
+  Hive<int> hive;
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_EQ(*hive.insert(i), i);
+  }
+  ASSERT_EQ(hive.size(), 1000);
+  int expected = 0;
+  for (auto it = hive.begin(); it != hive.end(); ++it) {
+    ASSERT_EQ(*it, expected++);
+  }
+  ASSERT_EQ(expected, 1000);
+}
+
+TEST(HiveTests, ReverseIteration) {
+  Hive<int> hive;
+  for (int i = 0; i < 100; ++i) {
+    hive.insert(i);
+  }
+  int expected = 99;
+  auto it = hive.end();
+  for (size_t i = 0; i < hive.size(); ++i) {
+    --it;
+    ASSERT_EQ(*it, expected--);
+  }
+  ASSERT_TRUE(it == hive.begin());
+}
+
+TEST(HiveTests, EraseKeepsPointersStable) {
+  Hive<int> hive;
+  std::vector<int *> ptrs;
+  for (int i = 0; i < 1000; ++i) {
+    ptrs.push_back(&*hive.insert(i));
+  }
+  for (int i = 0; i < 1000; i += 2) {
+    hive.erase(hive.get_iterator(ptrs[i]));
+  }
+  ASSERT_EQ(hive.size(), 500);
+  for (int i = 1; i < 1000; i += 2) {
+    ASSERT_EQ(*ptrs[i], i);
+  }
+  int expected = 1;
+  for (int value : hive) {
+    ASSERT_EQ(value, expected);
+    expected += 2;
+  }
+}
+
+TEST(HiveTests, EraseReturnsNext) {
+  Hive<int> hive{1, 2, 3, 4, 5};
+  auto it = hive.begin();
+  ++it;
+  it = hive.erase(it);
+  ASSERT_EQ(*it, 3);
+  it = hive.erase(it);
+  ASSERT_EQ(*it, 4);
+  ++it;
+  it = hive.erase(it);
+  ASSERT_TRUE(it == hive.end());
+  ASSERT_EQ(hive.size(), 2);
+}
+
+TEST(HiveTests, InsertReusesErasedSlots) {
+  Hive<int> hive;
+  for (int i = 0; i < 100; ++i) {
+    hive.insert(i);
+  }
+  size_t capacity = hive.capacity();
+  std::vector<int *> erased;
+  for (auto it = hive.begin(); it != hive.end();) {
+    if (*it % 3 == 0) {
+      erased.push_back(&*it);
+      it = hive.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  for (size_t i = 0; i < erased.size(); ++i) {
+    int *ptr = &*hive.insert(-1);
+    ASSERT_NE(std::find(erased.begin(), erased.end(), ptr), erased.end());
+  }
+  ASSERT_EQ(hive.capacity(), capacity);
+  ASSERT_EQ(hive.size(), 100);
+}
+
+TEST(HiveTests, EraseMergesRuns) {
+  Hive<int> hive;
+  std::vector<int *> ptrs;
+  for (int i = 0; i < 64; ++i) {
+    ptrs.push_back(&*hive.insert(i));
+  }
+  // Erase in an order that creates left, right and two-sided merges.
+  for (int i : {10, 12, 11, 14, 13, 20, 19, 18, 30, 31, 32}) {
+    hive.erase(hive.get_iterator(ptrs[i]));
+  }
+  std::set<int> removed{10, 11, 12, 13, 14, 18, 19, 20, 30, 31, 32};
+  std::vector<int> values;
+  for (int value : hive) {
+    values.push_back(value);
+  }
+  ASSERT_EQ(values.size(), 64 - removed.size());
+  for (int value : values) {
+    ASSERT_EQ(removed.count(value), 0);
+  }
+  std::vector<int> backwards;
+  for (auto it = hive.end(); it != hive.begin();) {
+    --it;
+    backwards.push_back(*it);
+  }
+  std::reverse(backwards.begin(), backwards.end());
+  ASSERT_EQ(values, backwards);
+}
+
+TEST(HiveTests, EraseEverything) {
+  Hive<int> hive;
+  for (int i = 0; i < 5000; ++i) {
+    hive.insert(i);
+  }
+  auto it = hive.begin();
+  while (it != hive.end()) {
+    it = hive.erase(it);
+  }
+  ASSERT_TRUE(hive.is_empty());
+  ASSERT_TRUE(hive.begin() == hive.end());
+  hive.insert(7);
+  ASSERT_EQ(*hive.begin(), 7);
+}
+
+TEST(HiveTests, EraseEmptyHive) {
+  Hive<int> hive;
+  EXPECT_THROW({ hive.erase(hive.begin()); }, HiveIsEmptyException);
+}
+
+TEST(HiveTests, RandomInsertErase) {
+  Hive<int> hive;
+  std::multiset<int> model;
+  std::vector<int *> ptrs;
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> op_dist(0, 2);
+  std::uniform_int_distribution<int> value_dist(0, 1 << 20);
+  for (int step = 0; step < 20000; ++step) {
+    if (ptrs.empty() || op_dist(gen) != 0) {
+      int value = value_dist(gen);
+      ptrs.push_back(&*hive.insert(value));
+      model.insert(value);
+    } else {
+      size_t pos = gen() % ptrs.size();
+      model.erase(model.find(*ptrs[pos]));
+      hive.erase(hive.get_iterator(ptrs[pos]));
+      ptrs[pos] = ptrs.back();
+      ptrs.pop_back();
+    }
+  }
+  ASSERT_EQ(hive.size(), model.size());
+  std::multiset<int> values;
+  for (int value : hive) {
+    values.insert(value);
+  }
+  ASSERT_EQ(values, model);
+}
+
+TEST(HiveTests, CopyAndMove) {
+  Hive<std::string> hive{"a", "b", "c"};
+  hive.erase(hive.begin());
+  Hive<std::string> copy = hive;
+  ASSERT_EQ(copy.size(), 2);
+  ASSERT_EQ(*copy.begin(), "b");
+  Hive<std::string> moved = std::move(hive);
+  ASSERT_EQ(moved.size(), 2);
+  ASSERT_EQ(hive.size(), 0);
+  copy = moved;
+  ASSERT_EQ(copy.size(), 2);
+}
+
+TEST(HiveTests, NonTrivialElements) {
+  Hive<std::unique_ptr<int>> hive;
+  for (int i = 0; i < 100; ++i) {
+    hive.emplace(new int(i));
+  }
+  for (auto it = hive.begin(); it != hive.end();) {
+    it = (**it % 2 == 0) ? hive.erase(it) : ++it;
+  }
+  ASSERT_EQ(hive.size(), 50);
+  hive.clear();
+  ASSERT_TRUE(hive.is_empty());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
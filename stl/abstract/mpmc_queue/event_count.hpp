@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Lets threads sleep until some lock-free condition may have changed, while
+// costing the notifying side only a fence and a load when nobody sleeps.
+//
+// Waiter:                            Notifier:
+//   key = prepare_wait();              <make the condition true>
+//   if (<condition true>) {            notify_one();
+//     cancel_wait();
+//   } else {
+//     wait(key);
+//   }
+//
+// prepare_wait announces the waiter before it re-checks the condition, and
+// notify looks for waiters only after publishing the change, so one of the
+// two always sees the other. wait() returns at once if any notification
+// happened after prepare_wait. On Linux sleeping is a futex on the epoch
+// word; elsewhere wait() just yields and the caller re-checks.
+class EventCount {
+public:
+  EventCount() : epoch_(0), waiters_(0) {}
+
+  EventCount(const EventCount &) = delete;
+
+  EventCount &operator=(const EventCount &) = delete;
+
+  uint32_t prepare_wait() {
+    waiters_.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return epoch_.load(std::memory_order_seq_cst);
+  }
+
+  void cancel_wait() { waiters_.fetch_sub(1, std::memory_order_relaxed); }
+
+  void wait(uint32_t key) {
+    if (epoch_.load(std::memory_order_acquire) == key) {
+#ifdef __linux__
+      syscall(SYS_futex, reinterpret_cast<uint32_t *>(&epoch_),
+              FUTEX_WAIT_PRIVATE, key, nullptr, nullptr, 0);
+#else
+      std::this_thread::yield();
+#endif
+    }
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void notify_one() { this->notify(1); }
+
+  void notify_all() { this->notify(INT_MAX); }
+
+private:
+  void notify(int count) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_relaxed) == 0) {
+      return;
+    }
+    epoch_.fetch_add(1, std::memory_order_seq_cst);
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&epoch_),
+            FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+#else
+    (void)count;
+#endif
+  }
+
+private:
+  static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+                "futex needs a plain 32-bit word");
+
+  std::atomic<uint32_t> epoch_;
+  std::atomic<uint32_t> waiters_;
+};
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "../../utils/cache_line.hpp"
+#include "event_count.hpp"
+// Failed attempts a blocking call spins through before it goes to sleep.
+const size_t MPMC_SPINS = 64;
+
+// Bounded multi-producer/multi-consumer queue (Vyukov). Every cell carries a
+// sequence number that says whose turn it is: a cell at position pos is free
+// for the producer of pos when seq == pos, and holds the element for the
+// consumer of pos when seq == pos + 1. After popping, the consumer sets
+// seq = pos + capacity, handing the cell to the producer one lap later.
+// Producers and consumers only contend on their own position counter, and a
+// full or empty queue is detected without touching the other side's one.
+//
+// Blocking push/pop spin briefly and then sleep on an EventCount, so threads
+// that only use try_push/try_pop pay a fence per operation and nothing more.
+template <typename T, class Allocator = std::allocator<T>> class MpmcQueue {
+  static_assert(std::is_nothrow_move_constructible<T>::value &&
+                    std::is_nothrow_move_assignable<T>::value,
+                "a claimed cell must always be filled and emptied");
+
+  struct Cell {
+    std::atomic<size_t> seq_;
+    alignas(T) unsigned char data_[sizeof(T)];
+
+    T *ptr() { return std::launder(reinterpret_cast<T *>(data_)); }
+  };
+
+  using CellAllocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<Cell>;
+
+public:
+  // The capacity is rounded up to a power of two, and to at least 2.
+  explicit MpmcQueue(size_t capacity) : mask_(1) {
+    while (mask_ + 1 < capacity) {
+      mask_ = (mask_ << 1) | 1;
+    }
+    cells_ = cell_alloc_.allocate(mask_ + 1);
+    for (size_t i = 0; i <= mask_; ++i) {
+      ::new (static_cast<void *>(cells_ + i)) Cell;
+      cells_[i].seq_.store(i, std::memory_order_relaxed);
+    }
+    enqueue_pos_.store(0, std::memory_order_relaxed);
+    dequeue_pos_.store(0, std::memory_order_relaxed);
+  }
+
+  MpmcQueue(const MpmcQueue &) = delete;
+
+  MpmcQueue &operator=(const MpmcQueue &) = delete;
+
+  ~MpmcQueue() {
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    size_t end = enqueue_pos_.load(std::memory_order_relaxed);
+    for (; pos != end; ++pos) {
+      std::allocator_traits<Allocator>::destroy(alloc_,
+                                                cells_[pos & mask_].ptr());
+    }
+    for (size_t i = 0; i <= mask_; ++i) {
+      cells_[i].~Cell();
+    }
+    cell_alloc_.deallocate(cells_, mask_ + 1);
+  }
+
+  bool try_push(const T &val) { return this->try_emplace(val); }
+
+  bool try_push(T &&val) { return this->try_emplace(std::move(val)); }
+
+  template <class... Args> bool try_emplace(Args &&...args) {
+    if constexpr (std::is_nothrow_constructible<T, Args &&...>::value) {
+      return this->emplace_impl(std::forward<Args>(args)...);
+    } else {
+      // Build the element before claiming a cell: once claimed, the cell
+      // must be published or every later consumer would stall on it.
+      T val(std::forward<Args>(args)...);
+      return this->emplace_impl(std::move(val));
+    }
+  }
+
+  bool try_pop(T &out) {
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    Cell *cell;
+    while (true) {
+      cell = cells_ + (pos & mask_);
+      size_t seq = cell->seq_.load(std::memory_order_acquire);
+      auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    out = std::move(*cell->ptr());
+    std::allocator_traits<Allocator>::destroy(alloc_, cell->ptr());
+    cell->seq_.store(pos + mask_ + 1, std::memory_order_release);
+    not_full_.notify_one();
+    return true;
+  }
+
+  void push(const T &val) { this->emplace(val); }
+
+  void push(T &&val) { this->emplace(std::move(val)); }
+
+  // Waits while the queue is full.
+  template <class... Args> void emplace(Args &&...args) {
+    T val(std::forward<Args>(args)...);
+    for (size_t spin = 0; spin < MPMC_SPINS; ++spin) {
+      if (this->emplace_impl(std::move(val))) {
+        return;
+      }
+    }
+    while (true) {
+      uint32_t key = not_full_.prepare_wait();
+      if (this->emplace_impl(std::move(val))) {
+        not_full_.cancel_wait();
+        return;
+      }
+      not_full_.wait(key);
+    }
+  }
+
+  // Waits while the queue is empty.
+  void pop(T &out) {
+    for (size_t spin = 0; spin < MPMC_SPINS; ++spin) {
+      if (this->try_pop(out)) {
+        return;
+      }
+    }
+    while (true) {
+      uint32_t key = not_empty_.prepare_wait();
+      if (this->try_pop(out)) {
+        not_empty_.cancel_wait();
+        return;
+      }
+      not_empty_.wait(key);
+    }
+  }
+
+  // Only a snapshot while other threads are running.
+  size_t size() const {
+    size_t head = dequeue_pos_.load(std::memory_order_acquire);
+    size_t tail = enqueue_pos_.load(std::memory_order_acquire);
+    return tail > head ? tail - head : 0;
+  }
+
+  bool is_empty() const { return this->size() == 0; }
+
+  size_t capacity() const { return mask_ + 1; }
+
+private:
+  // Constructs from args only after a cell is claimed; callers make sure
+  // that construction cannot throw.
+  template <class... Args> bool emplace_impl(Args &&...args) {
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Cell *cell;
+    while (true) {
+      cell = cells_ + (pos & mask_);
+      size_t seq = cell->seq_.load(std::memory_order_acquire);
+      auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    std::allocator_traits<Allocator>::construct(alloc_, cell->ptr(),
+                                                std::forward<Args>(args)...);
+    cell->seq_.store(pos + 1, std::memory_order_release);
+    not_empty_.notify_one();
+    return true;
+  }
+
+private:
+  Cell *cells_;
+  size_t mask_;
+  Allocator alloc_;
+  CellAllocator cell_alloc_;
+  alignas(CACHE_LINE) std::atomic<size_t> enqueue_pos_;
+  alignas(CACHE_LINE) std::atomic<size_t> dequeue_pos_;
+  alignas(CACHE_LINE) EventCount not_empty_;
+  alignas(CACHE_LINE) EventCount not_full_;
+};
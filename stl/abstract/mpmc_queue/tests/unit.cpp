@@ -0,0 +1,142 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../mpmc_queue.hpp"
+
+TEST(MpmcQueueTests, CapacityRoundsUp) {
+  MpmcQueue<int> queue(100);
+  ASSERT_EQ(queue.capacity(), 128);
+  MpmcQueue<int> tiny(1);
+  ASSERT_EQ(tiny.capacity(), 2);
+}
+
+TEST(MpmcQueueTests, FifoAndBounds) {
+  MpmcQueue<int> queue(8);
+  int value = 0;
+  ASSERT_FALSE(queue.try_pop(value));
+  for (int lap = 0; lap < 10; ++lap) {
+    for (int i = 0; i < 8; ++i) {
+      ASSERT_TRUE(queue.try_push(lap * 8 + i));
+    }
+    ASSERT_FALSE(queue.try_push(-1));
+    ASSERT_EQ(queue.size(), 8);
+    for (int i = 0; i < 8; ++i) {
+      ASSERT_TRUE(queue.try_pop(value));
+      ASSERT_EQ(value, lap * 8 + i);
+    }
+    ASSERT_FALSE(queue.try_pop(value));
+    ASSERT_TRUE(queue.is_empty());
+  }
+}
+
+TEST(MpmcQueueTests, ThrowingConstructorClaimsNothing) {
+  struct Fragile {
+    Fragile() = default;
+    explicit Fragile(int value) : value_(value) {
+      if (value < 0) {
+        throw std::runtime_error("negative");
+      }
+    }
+    int value_ = 0;
+  };
+  MpmcQueue<Fragile> queue(4);
+  EXPECT_THROW({ queue.try_emplace(-1); }, std::runtime_error);
+  ASSERT_TRUE(queue.try_emplace(5));
+  Fragile value;
+  ASSERT_TRUE(queue.try_pop(value));
+  ASSERT_EQ(value.value_, 5);
+  ASSERT_TRUE(queue.is_empty());
+}
+
+TEST(MpmcQueueTests, DestructorReleasesElements) {
+  MpmcQueue<std::unique_ptr<std::string>> queue(16);
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(queue.try_emplace(new std::string(std::to_string(i))));
+  }
+  std::unique_ptr<std::string> value;
+  ASSERT_TRUE(queue.try_pop(value));
+  ASSERT_EQ(*value, "0");
+}
+
+TEST(MpmcQueueTests, ManyProducersManyConsumers) {
+  const int producers = 4;
+  const int consumers = 4;
+  const int per_producer = 100000;
+  MpmcQueue<int> queue(64);
+  std::atomic<long long> sum{0};
+  std::atomic<int> received{0};
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p] {
+      for (int i = 0; i < per_producer; ++i) {
+        int value = p * per_producer + i;
+        if (i % 2 == 0) {
+          queue.push(value);
+        } else {
+          while (!queue.try_push(value)) {
+            std::this_thread::yield();
+          }
+        }
+      }
+    });
+  }
+  std::vector<std::vector<int>> last(consumers,
+                                     std::vector<int>(producers, -1));
+  std::atomic<bool> ordered{true};
+  for (int c = 0; c < consumers; ++c) {
+    threads.emplace_back([&, c] {
+      while (received.fetch_add(1) < producers * per_producer) {
+        int value = 0;
+        queue.pop(value);
+        // Elements of one producer reach any single consumer in order.
+        int producer = value / per_producer;
+        if (value <= last[c][producer]) {
+          ordered = false;
+        }
+        last[c][producer] = value;
+        sum += value;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  long long total = static_cast<long long>(producers) * per_producer;
+  ASSERT_EQ(sum.load(), total * (total - 1) / 2);
+  ASSERT_TRUE(ordered.load());
+  ASSERT_TRUE(queue.is_empty());
+}
+
+TEST(MpmcQueueTests, BlockingCallsWakeUp) {
+  MpmcQueue<int> queue(2);
+  std::thread consumer([&] {
+    for (int i = 0; i < 1000; ++i) {
+      int value = -1;
+      queue.pop(value);
+      ASSERT_EQ(value, i);
+      if (i % 100 == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+  });
+  for (int i = 0; i < 1000; ++i) {
+    queue.push(i);
+    if (i % 128 == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  consumer.join();
+  ASSERT_TRUE(queue.is_empty());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
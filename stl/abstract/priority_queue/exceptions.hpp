@@ -0,0 +1,26 @@
+#pragma once
+
+#include <exception>
+#include <string>
+
+class PriorityQueueIsEmptyException : std::exception {
+public:
+  explicit PriorityQueueIsEmptyException(const std::string &text)
+      : error_message_(text) {}
+
+  const char *what() const noexcept override { return error_message_.data(); }
+
+private:
+  std::string_view error_message_;
+};
+
+class InvalidHandleException : std::exception {
+public:
+  explicit InvalidHandleException(const std::string &text)
+      : error_message_(text) {}
+
+  const char *what() const noexcept override { return error_message_.data(); }
+
+private:
+  std::string_view error_message_;
+};
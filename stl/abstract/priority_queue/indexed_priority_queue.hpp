@@ -0,0 +1,193 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+#include "exceptions.hpp"
+#include "vector.cpp"
+
+// d-ary heap whose elements can be reached after insertion. push() returns a
+// handle that stays valid until the element is popped or erased; handles of
+// removed elements are recycled. Each heap slot stores the handle next to the
+// value, and positions_[handle] follows the element as it moves, so
+// decrease_key, update and erase are O(log n) with no search.
+template <typename T, size_t Arity = 4, class Compare = std::less<T>>
+class IndexedPriorityQueue {
+  static_assert(Arity >= 2, "a heap needs at least two children per node");
+
+  static constexpr size_t NO_POS = static_cast<size_t>(-1);
+
+  struct Entry {
+    T value_;
+    size_t handle_;
+  };
+
+public:
+  using Handle = size_t;
+
+  IndexedPriorityQueue() = default;
+
+  explicit IndexedPriorityQueue(const Compare &comp) : comp_(comp) {}
+
+  const T &top() const {
+    if (heap_.is_empty()) {
+      throw PriorityQueueIsEmptyException("priority queue is empty");
+    }
+    return heap_.data()[0].value_;
+  }
+
+  Handle top_handle() const {
+    if (heap_.is_empty()) {
+      throw PriorityQueueIsEmptyException("priority queue is empty");
+    }
+    return heap_.data()[0].handle_;
+  }
+
+  Handle push(const T &val) { return this->emplace(val); }
+
+  Handle push(T &&val) { return this->emplace(std::move(val)); }
+
+  template <class... Args> Handle emplace(Args &&...args) {
+    Handle handle;
+    if (free_handles_.is_empty()) {
+      handle = positions_.size();
+      positions_.push_back(heap_.size());
+    } else {
+      handle = free_handles_.back();
+      free_handles_.pop_back();
+      positions_[handle] = heap_.size();
+    }
+    heap_.push_back(Entry{T(std::forward<Args>(args)...), handle});
+    this->sift_up(heap_.size() - 1);
+    return handle;
+  }
+
+  void pop() {
+    if (heap_.is_empty()) {
+      throw PriorityQueueIsEmptyException("priority queue is empty");
+    }
+    this->remove_at(0);
+  }
+
+  bool contains(Handle handle) const {
+    return handle < positions_.size() && positions_.data()[handle] != NO_POS;
+  }
+
+  const T &get(Handle handle) const {
+    return heap_.data()[this->position(handle)].value_;
+  }
+
+  // Gives the element a value that ranks at least as high as its current one
+  // (for a std::greater min-heap: a smaller key), so it can only move up.
+  void decrease_key(Handle handle, T val) {
+    size_t pos = this->position(handle);
+    heap_[pos].value_ = std::move(val);
+    this->sift_up(pos);
+  }
+
+  // Replaces the value when the direction of the change is not known.
+  void update(Handle handle, T val) {
+    size_t pos = this->position(handle);
+    bool up = comp_(heap_[pos].value_, val);
+    heap_[pos].value_ = std::move(val);
+    if (up) {
+      this->sift_up(pos);
+    } else {
+      this->sift_down(pos);
+    }
+  }
+
+  void erase(Handle handle) { this->remove_at(this->position(handle)); }
+
+  size_t size() const { return heap_.size(); }
+
+  bool is_empty() const { return heap_.is_empty(); }
+
+  void clear() {
+    heap_.clear();
+    positions_.clear();
+    free_handles_.clear();
+  }
+
+private:
+  size_t position(Handle handle) const {
+    if (!this->contains(handle)) {
+      throw InvalidHandleException("handle does not refer to an element");
+    }
+    return positions_.data()[handle];
+  }
+
+  void remove_at(size_t pos) {
+    Entry *arr = heap_.data();
+    size_t handle = arr[pos].handle_;
+    size_t last = heap_.size() - 1;
+    if (pos != last) {
+      arr[pos] = std::move(arr[last]);
+      positions_[arr[pos].handle_] = pos;
+    }
+    heap_.pop_back();
+    positions_[handle] = NO_POS;
+    free_handles_.push_back(handle);
+    if (pos < last) {
+      // The moved-in element came from a leaf elsewhere in the heap and may
+      // belong above or below this slot.
+      if (pos > 0 && comp_(arr[(pos - 1) / Arity].value_, arr[pos].value_)) {
+        this->sift_up(pos);
+      } else {
+        this->sift_down(pos);
+      }
+    }
+  }
+
+  void place(size_t pos, Entry &&entry) {
+    positions_.data()[entry.handle_] = pos;
+    heap_.data()[pos] = std::move(entry);
+  }
+
+  void sift_up(size_t pos) {
+    Entry *arr = heap_.data();
+    Entry entry = std::move(arr[pos]);
+    while (pos > 0) {
+      size_t parent = (pos - 1) / Arity;
+      if (!comp_(arr[parent].value_, entry.value_)) {
+        break;
+      }
+      this->place(pos, std::move(arr[parent]));
+      pos = parent;
+    }
+    this->place(pos, std::move(entry));
+  }
+
+  void sift_down(size_t pos) {
+    Entry *arr = heap_.data();
+    size_t count = heap_.size();
+    Entry entry = std::move(arr[pos]);
+    while (true) {
+      size_t first = pos * Arity + 1;
+      if (first >= count) {
+        break;
+      }
+      size_t last = first + Arity < count ? first + Arity : count;
+      size_t best = first;
+      for (size_t child = first + 1; child < last; ++child) {
+        if (comp_(arr[best].value_, arr[child].value_)) {
+          best = child;
+        }
+      }
+      if (!comp_(entry.value_, arr[best].value_)) {
+        break;
+      }
+      this->place(pos, std::move(arr[best]));
+      pos = best;
+    }
+    this->place(pos, std::move(entry));
+  }
+
+private:
+  vector<Entry> heap_;
+  // positions_[handle] is the heap slot of the element, or NO_POS.
+  vector<size_t> positions_;
+  vector<Handle> free_handles_;
+  Compare comp_;
+};
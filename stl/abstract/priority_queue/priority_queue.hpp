@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+#include "exceptions.hpp"
+#include "vector.cpp"
+
+// d-ary heap on top of vector. top() is the element that no other element
+// outranks under Compare, so the default std::less gives a max-heap, like
+// std::priority_queue. A 4- or 8-ary heap is half or a third as deep as a
+// binary one, and the children of a node are adjacent, so each level of a
+// sift-down scans one or two cache lines instead of chasing two pointers.
+template <typename T, size_t Arity = 4, class Compare = std::less<T>>
+class PriorityQueue {
+  static_assert(Arity >= 2, "a heap needs at least two children per node");
+
+public:
+  PriorityQueue() = default;
+
+  explicit PriorityQueue(const Compare &comp) : comp_(comp) {}
+
+  // Takes the items over and heapifies them bottom-up in O(n).
+  explicit PriorityQueue(vector<T> &&items, const Compare &comp = Compare())
+      : heap_(std::move(items)), comp_(comp) {
+    size_t count = heap_.size();
+    if (count < 2) {
+      return;
+    }
+    for (size_t pos = (count - 2) / Arity + 1; pos > 0; --pos) {
+      this->sift_down(pos - 1);
+    }
+  }
+
+  const T &top() const {
+    if (heap_.is_empty()) {
+      throw PriorityQueueIsEmptyException("priority queue is empty");
+    }
+    return heap_.data()[0];
+  }
+
+  void push(const T &val) { this->emplace(val); }
+
+  void push(T &&val) { this->emplace(std::move(val)); }
+
+  template <class... Args> void emplace(Args &&...args) {
+    heap_.emplace_back(std::forward<Args>(args)...);
+    this->sift_up(heap_.size() - 1);
+  }
+
+  void pop() {
+    if (heap_.is_empty()) {
+      throw PriorityQueueIsEmptyException("priority queue is empty");
+    }
+    T *arr = heap_.data();
+    size_t last = heap_.size() - 1;
+    if (last != 0) {
+      arr[0] = std::move(arr[last]);
+    }
+    heap_.pop_back();
+    if (last > 1) {
+      this->sift_down(0);
+    }
+  }
+
+  size_t size() const { return heap_.size(); }
+
+  bool is_empty() const { return heap_.is_empty(); }
+
+  void clear() { heap_.clear(); }
+
+private:
+  // Both sifts carry the moving element in a local and shift the others into
+  // the hole, so each level costs one move instead of a swap.
+  void sift_up(size_t pos) {
+    T *arr = heap_.data();
+    T val = std::move(arr[pos]);
+    while (pos > 0) {
+      size_t parent = (pos - 1) / Arity;
+      if (!comp_(arr[parent], val)) {
+        break;
+      }
+      arr[pos] = std::move(arr[parent]);
+      pos = parent;
+    }
+    arr[pos] = std::move(val);
+  }
+
+  void sift_down(size_t pos) {
+    T *arr = heap_.data();
+    size_t count = heap_.size();
+    T val = std::move(arr[pos]);
+    while (true) {
+      size_t first = pos * Arity + 1;
+      if (first >= count) {
+        break;
+      }
+      size_t last = first + Arity < count ? first + Arity : count;
+      size_t best = first;
+      for (size_t child = first + 1; child < last; ++child) {
+        if (comp_(arr[best], arr[child])) {
+          best = child;
+        }
+      }
+      if (!comp_(val, arr[best])) {
+        break;
+      }
+      arr[pos] = std::move(arr[best]);
+      pos = best;
+    }
+    arr[pos] = std::move(val);
+  }
+
+private:
+  vector<T> heap_;
+  Compare comp_;
+};
@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "../indexed_priority_queue.hpp"
+#include "../priority_queue.hpp"
+
+template <size_t Arity> void CheckRandomOrder() {
+  PriorityQueue<int, Arity> queue;
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<int> op_dist(0, 2);
+  std::uniform_int_distribution<int> value_dist(0, 99999);
+  std::multimap<int, int> model;
+  for (int step = 0; step < 20000; ++step) {
+    if (queue.is_empty() || op_dist(gen) != 0) {
+      int value = value_dist(gen);
+      queue.push(value);
+      model.emplace(value, 0);
+    } else {
+      ASSERT_EQ(queue.top(), model.rbegin()->first);
+      queue.pop();
+      model.erase(std::prev(model.end()));
+    }
+  }
+  ASSERT_EQ(queue.size(), model.size());
+  while (!queue.is_empty()) {
+    ASSERT_EQ(queue.top(), model.rbegin()->first);
+    queue.pop();
+    model.erase(std::prev(model.end()));
+  }
+}
+
+TEST(PriorityQueueTests, BinaryHeap) { CheckRandomOrder<2>(); }
+
+TEST(PriorityQueueTests, QuaternaryHeap) { CheckRandomOrder<4>(); }
+
+TEST(PriorityQueueTests, OctonaryHeap) { CheckRandomOrder<8>(); }
+
+TEST(PriorityQueueTests, MinHeap) {
+  PriorityQueue<std::string, 4, std::greater<std::string>> queue;
+  for (const char *word : {"pear", "apple", "fig", "kiwi", "banana"}) {
+    queue.emplace(word);
+  }
+  ASSERT_EQ(queue.top(), "apple");
+  queue.pop();
+  ASSERT_EQ(queue.top(), "banana");
+  ASSERT_EQ(queue.size(), 4);
+}
+
+TEST(PriorityQueueTests, Heapify) {
+  vector<int> items;
+  for (int i = 0; i < 1000; ++i) {
+    items.push_back((i * 7919) % 1000);
+  }
+  PriorityQueue<int, 4> queue(std::move(items));
+  for (int expected = 999; expected >= 0; --expected) {
+    ASSERT_EQ(queue.top(), expected);
+    queue.pop();
+  }
+  ASSERT_TRUE(queue.is_empty());
+}
+
+TEST(PriorityQueueTests, EmptyQueue) {
+  PriorityQueue<int> queue;
+  EXPECT_THROW({ queue.top(); }, PriorityQueueIsEmptyException);
+  EXPECT_THROW({ queue.pop(); }, PriorityQueueIsEmptyException);
+}
+
+TEST(IndexedPriorityQueueTests, HandlesFollowElements) {
+  IndexedPriorityQueue<int, 4, std::greater<int>> queue;
+  vector<size_t> handles;
+  for (int i = 0; i < 100; ++i) {
+    handles.push_back(queue.push(1000 + i));
+  }
+  queue.decrease_key(handles[50], 5);
+  ASSERT_EQ(queue.top(), 5);
+  ASSERT_EQ(queue.top_handle(), handles[50]);
+  queue.update(handles[50], 2000);
+  ASSERT_EQ(queue.top(), 1000);
+  ASSERT_EQ(queue.get(handles[50]), 2000);
+  queue.erase(handles[0]);
+  ASSERT_FALSE(queue.contains(handles[0]));
+  ASSERT_EQ(queue.top(), 1001);
+  ASSERT_EQ(queue.size(), 99);
+  size_t reused = queue.push(1);
+  ASSERT_EQ(reused, handles[0]);
+  ASSERT_EQ(queue.top_handle(), reused);
+}
+
+TEST(IndexedPriorityQueueTests, InvalidHandles) {
+  IndexedPriorityQueue<int> queue;
+  size_t handle = queue.push(1);
+  queue.pop();
+  EXPECT_THROW({ queue.erase(handle); }, InvalidHandleException);
+  EXPECT_THROW({ queue.update(42, 1); }, InvalidHandleException);
+  EXPECT_THROW({ queue.top_handle(); }, PriorityQueueIsEmptyException);
+}
+
+TEST(IndexedPriorityQueueTests, RandomOperations) {
+  IndexedPriorityQueue<long long, 8> queue;
+  std::map<size_t, long long> model;
+  std::mt19937 gen(3);
+  std::uniform_int_distribution<int> op_dist(0, 4);
+  std::uniform_int_distribution<long long> value_dist(0, 999999);
+  for (int step = 0; step < 50000; ++step) {
+    int op = op_dist(gen);
+    long long value = value_dist(gen);
+    if (model.empty() || op == 0 || op == 1) {
+      model[queue.push(value)] = value;
+      continue;
+    }
+    auto it = model.begin();
+    std::advance(it, gen() % model.size());
+    if (op == 2) {
+      queue.update(it->first, value);
+      it->second = value;
+    } else if (op == 3) {
+      queue.erase(it->first);
+      model.erase(it);
+    } else {
+      auto best = std::max_element(
+          model.begin(), model.end(),
+          [](const auto &a, const auto &b) { return a.second < b.second; });
+      ASSERT_EQ(queue.top(), best->second);
+      ASSERT_EQ(queue.get(queue.top_handle()), best->second);
+      model.erase(queue.top_handle());
+      queue.pop();
+    }
+    ASSERT_EQ(queue.size(), model.size());
+  }
+}
+
+TEST(IndexedPriorityQueueTests, Dijkstra) {
+  const size_t nodes = 500;
+  vector<vector<std::pair<size_t, long long>>> edges;
+  for (size_t i = 0; i < nodes; ++i) {
+    edges.push_back(vector<std::pair<size_t, long long>>());
+  }
+  std::mt19937 gen(11);
+  std::uniform_int_distribution<size_t> node_dist(0, nodes - 1);
+  std::uniform_int_distribution<long long> weight_dist(1, 100);
+  for (size_t i = 0; i < nodes * 8; ++i) {
+    size_t from = node_dist(gen);
+    size_t to = node_dist(gen);
+    edges[from].push_back({to, weight_dist(gen)});
+  }
+  const long long inf = std::numeric_limits<long long>::max();
+
+  // Reference: Bellman-Ford.
+  vector<long long> expected(nodes, inf);
+  expected[0] = 0;
+  for (size_t round = 0; round < nodes; ++round) {
+    for (size_t from = 0; from < nodes; ++from) {
+      if (expected[from] == inf) {
+        continue;
+      }
+      for (auto &edge : edges[from]) {
+        expected[edge.first] =
+            std::min(expected[edge.first], expected[from] + edge.second);
+      }
+    }
+  }
+
+  IndexedPriorityQueue<std::pair<long long, size_t>, 4,
+                       std::greater<std::pair<long long, size_t>>>
+      queue;
+  vector<long long> dist(nodes, inf);
+  vector<size_t> handle(nodes, static_cast<size_t>(-1));
+  dist[0] = 0;
+  handle[0] = queue.push({0, 0});
+  while (!queue.is_empty()) {
+    auto [d, node] = queue.top();
+    queue.pop();
+    for (auto &edge : edges[node]) {
+      long long candidate = d + edge.second;
+      if (candidate >= dist[edge.first]) {
+        continue;
+      }
+      dist[edge.first] = candidate;
+      if (queue.contains(handle[edge.first]) &&
+          queue.get(handle[edge.first]).second == edge.first) {
+        queue.decrease_key(handle[edge.first], {candidate, edge.first});
+      } else {
+        handle[edge.first] = queue.push({candidate, edge.first});
+      }
+    }
+  }
+  for (size_t i = 0; i < nodes; ++i) {
+    ASSERT_EQ(dist[i], expected[i]) << i;
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <exception>
+#include <string>
+
+class RingDequeIsEmptyException : std::exception {
+public:
+  explicit RingDequeIsEmptyException(const std::string &text)
+      : error_message_(text) {}
+
+  const char *what() const noexcept override { return error_message_.data(); }
+
+private:
+  std::string_view error_message_;
+};
+
+class RingDequeIsFullException : std::exception {
+public:
+  explicit RingDequeIsFullException(const std::string &text)
+      : error_message_(text) {}
+
+  const char *what() const noexcept override { return error_message_.data(); }
+
+private:
+  std::string_view error_message_;
+};
@@ -0,0 +1,273 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include "exceptions.hpp"
+
+// What a full ring does when another element is pushed.
+enum class RingOverflow {
+  // Throw RingDequeIsFullException and leave the ring untouched.
+  THROW,
+  // Drop the element at the opposite end: push_back evicts the front (the
+  // oldest element of a FIFO), push_front evicts the back.
+  OVERWRITE,
+};
+
+constexpr size_t RingCapacity(size_t requested) {
+  size_t capacity = 1;
+  while (capacity < requested) {
+    capacity <<= 1;
+  }
+  return capacity;
+}
+
+// Bounded deque over one contiguous power-of-two array. head_ and tail_ are
+// free-running counters, so a position is just `counter & mask` and the size
+// is tail_ - head_ even after the counters wrap. Capacity == 0 means the
+// capacity is chosen at construction time and rounded up to a power of two.
+// The array is allocated on the first push.
+template <typename T, size_t Capacity = 0,
+          RingOverflow Policy = RingOverflow::THROW,
+          class Allocator = std::allocator<T>>
+class RingDeque {
+  static_assert((Capacity & (Capacity - 1)) == 0,
+                "RingDeque capacity must be a power of two");
+
+public:
+  RingDeque() : RingDeque(Capacity) {
+    static_assert(Capacity != 0, "runtime-sized RingDeque needs a capacity");
+  }
+
+  // With a fixed Capacity the argument is ignored.
+  explicit RingDeque(size_t capacity)
+      : data_(nullptr), mask_(RingCapacity(capacity) - 1), head_(0),
+        tail_(0) {}
+
+  RingDeque(const RingDeque &other) : RingDeque(other.capacity()) {
+    for (size_t i = 0; i < other.size(); ++i) {
+      this->push_back(other[i]);
+    }
+  }
+
+  RingDeque(RingDeque &&other) noexcept
+      : data_(other.data_), mask_(other.mask_), head_(other.head_),
+        tail_(other.tail_) {
+    other.data_ = nullptr;
+    other.head_ = 0;
+    other.tail_ = 0;
+  }
+
+  RingDeque &operator=(const RingDeque &other) {
+    if (this != &other) {
+      RingDeque copy(other);
+      this->swap(copy);
+    }
+    return *this;
+  }
+
+  RingDeque &operator=(RingDeque &&other) noexcept {
+    if (this != &other) {
+      this->swap(other);
+    }
+    return *this;
+  }
+
+  ~RingDeque() {
+    if (data_ == nullptr) {
+      return;
+    }
+    this->clear();
+    alloc_.deallocate(data_, this->capacity());
+  }
+
+public:
+  class RingDequeIterator {
+  public:
+    // NOLINTNEXTLINE
+    using value_type = T;
+    // NOLINTNEXTLINE
+    using reference_type = value_type &;
+    // NOLINTNEXTLINE
+    using pointer_type = value_type *;
+    // NOLINTNEXTLINE
+    using difference_type = std::ptrdiff_t;
+    // NOLINTNEXTLINE
+    using iterator_category = std::bidirectional_iterator_tag;
+
+    inline bool operator==(const RingDequeIterator &other) const {
+      return pos_ == other.pos_;
+    }
+
+    inline bool operator!=(const RingDequeIterator &other) const {
+      return pos_ != other.pos_;
+    }
+
+    T &operator*() const { return data_[pos_ & mask_]; }
+
+    T *operator->() const { return data_ + (pos_ & mask_); }
+
+    RingDequeIterator &operator++() {
+      ++pos_;
+      return *this;
+    }
+
+    RingDequeIterator operator++(int) {
+      RingDequeIterator new_iter(*this);
+      ++pos_;
+      return new_iter;
+    }
+
+    RingDequeIterator &operator--() {
+      --pos_;
+      return *this;
+    }
+
+    RingDequeIterator operator--(int) {
+      RingDequeIterator new_iter(*this);
+      --pos_;
+      return new_iter;
+    }
+
+  private:
+    friend class RingDeque;
+    RingDequeIterator(T *data, size_t mask, size_t pos)
+        : data_(data), mask_(mask), pos_(pos) {}
+
+  private:
+    T *data_;
+    size_t mask_;
+    size_t pos_;
+  };
+
+  RingDequeIterator begin() const {
+    return RingDequeIterator(data_, this->mask(), head_);
+  }
+
+  RingDequeIterator end() const {
+    return RingDequeIterator(data_, this->mask(), tail_);
+  }
+
+  void push_back(const T &val) { this->emplace_back(val); }
+
+  void push_back(T &&val) { this->emplace_back(std::move(val)); }
+
+  template <class... Args> void emplace_back(Args &&...args) {
+    if (this->is_full()) {
+      if constexpr (Policy == RingOverflow::THROW) {
+        throw RingDequeIsFullException("ring deque is full");
+      } else {
+        // The new element goes into the slot of the one it evicts, so it is
+        // built first in case the arguments refer to that element.
+        T val(std::forward<Args>(args)...);
+        this->pop_front();
+        this->construct(tail_, std::move(val));
+        ++tail_;
+        return;
+      }
+    }
+    this->construct(tail_, std::forward<Args>(args)...);
+    ++tail_;
+  }
+
+  void push_front(const T &val) { this->emplace_front(val); }
+
+  void push_front(T &&val) { this->emplace_front(std::move(val)); }
+
+  template <class... Args> void emplace_front(Args &&...args) {
+    if (this->is_full()) {
+      if constexpr (Policy == RingOverflow::THROW) {
+        throw RingDequeIsFullException("ring deque is full");
+      } else {
+        T val(std::forward<Args>(args)...);
+        this->pop_back();
+        this->construct(head_ - 1, std::move(val));
+        --head_;
+        return;
+      }
+    }
+    this->construct(head_ - 1, std::forward<Args>(args)...);
+    --head_;
+  }
+
+  void pop_back() {
+    if (this->is_empty()) {
+      throw RingDequeIsEmptyException("ring deque is empty");
+    }
+    --tail_;
+    std::allocator_traits<Allocator>::destroy(alloc_, this->slot(tail_));
+  }
+
+  void pop_front() {
+    if (this->is_empty()) {
+      throw RingDequeIsEmptyException("ring deque is empty");
+    }
+    std::allocator_traits<Allocator>::destroy(alloc_, this->slot(head_));
+    ++head_;
+  }
+
+  T &back() {
+    if (this->is_empty()) {
+      throw RingDequeIsEmptyException("ring deque is empty");
+    }
+    return *this->slot(tail_ - 1);
+  }
+
+  T &front() {
+    if (this->is_empty()) {
+      throw RingDequeIsEmptyException("ring deque is empty");
+    }
+    return *this->slot(head_);
+  }
+
+  T &operator[](size_t pos) { return *this->slot(head_ + pos); }
+
+  const T &operator[](size_t pos) const { return *this->slot(head_ + pos); }
+
+  void clear() {
+    while (head_ != tail_) {
+      std::allocator_traits<Allocator>::destroy(alloc_, this->slot(head_));
+      ++head_;
+    }
+    head_ = 0;
+    tail_ = 0;
+  }
+
+  void swap(RingDeque &other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(mask_, other.mask_);
+    std::swap(head_, other.head_);
+    std::swap(tail_, other.tail_);
+  }
+
+  size_t size() const { return tail_ - head_; }
+
+  size_t capacity() const { return this->mask() + 1; }
+
+  bool is_empty() const { return head_ == tail_; }
+
+  bool is_full() const { return tail_ - head_ == this->mask() + 1; }
+
+private:
+  size_t mask() const { return Capacity != 0 ? Capacity - 1 : mask_; }
+
+  T *slot(size_t pos) const { return data_ + (pos & this->mask()); }
+
+  template <class... Args> void construct(size_t pos, Args &&...args) {
+    if (data_ == nullptr) {
+      data_ = alloc_.allocate(this->capacity());
+    }
+    std::allocator_traits<Allocator>::construct(alloc_, this->slot(pos),
+                                                std::forward<Args>(args)...);
+  }
+
+private:
+  T *data_;
+  // Only read when Capacity == 0; otherwise mask() is a constant.
+  size_t mask_;
+  size_t head_;
+  size_t tail_;
+  Allocator alloc_;
+};
@@ -0,0 +1,121 @@
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "../ring_deque.hpp"
+
+TEST(RingDequeTests, DefaultConstructor) {
+  RingDeque<int, 8> ring;
+  ASSERT_EQ(ring.size(), 0);
+  ASSERT_EQ(ring.capacity(), 8);
+  ASSERT_TRUE(ring.is_empty());
+  ASSERT_TRUE(ring.begin() == ring.end());
+}
+
+TEST(RingDequeTests, RuntimeCapacityRoundsUp) {
+  RingDeque<int> ring(100);
+  ASSERT_EQ(ring.capacity(), 128);
+  RingDeque<int> single(0);
+  ASSERT_EQ(single.capacity(), 1);
+}
+
+TEST(RingDequeTests, PushBothEnds) {
+  RingDeque<int, 16> ring;
+  for (int i = 0; i < 8; ++i) {
+    ring.push_back(i);
+    ring.push_front(-i - 1);
+  }
+  ASSERT_TRUE(ring.is_full());
+  for (int i = 0; i < 16; ++i) {
+    ASSERT_EQ(ring[i], i - 8);
+  }
+  ASSERT_EQ(ring.front(), -8);
+  ASSERT_EQ(ring.back(), 7);
+}
+
+TEST(RingDequeTests, WrapsAround) {
+  RingDeque<int> ring(4);
+  for (int i = 0; i < 1000; ++i) {
+    ring.push_back(i);
+    if (ring.size() == 3) {
+      ASSERT_EQ(ring.front(), i - 2);
+      ring.pop_front();
+    }
+  }
+  int expected = 998;
+  for (int value : ring) {
+    ASSERT_EQ(value, expected++);
+  }
+  ASSERT_EQ(expected, 1000);
+}
+
+TEST(RingDequeTests, ThrowWhenFull) {
+  RingDeque<int, 2> ring;
+  ring.push_back(1);
+  ring.push_back(2);
+  EXPECT_THROW({ ring.push_back(3); }, RingDequeIsFullException);
+  EXPECT_THROW({ ring.push_front(0); }, RingDequeIsFullException);
+  ASSERT_EQ(ring.front(), 1);
+  ASSERT_EQ(ring.back(), 2);
+}
+
+TEST(RingDequeTests, OverwriteOldest) {
+  RingDeque<int, 4, RingOverflow::OVERWRITE> ring;
+  for (int i = 0; i < 10; ++i) {
+    ring.push_back(i);
+  }
+  ASSERT_EQ(ring.size(), 4);
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ(ring[i], 6 + i);
+  }
+  ring.push_front(100);
+  ASSERT_EQ(ring.front(), 100);
+  ASSERT_EQ(ring.back(), 8);
+  ring.push_back(ring.front());
+  ASSERT_EQ(ring.front(), 6);
+  ASSERT_EQ(ring.back(), 100);
+}
+
+TEST(RingDequeTests, PopEmpty) {
+  RingDeque<int, 4> ring;
+  EXPECT_THROW({ ring.pop_back(); }, RingDequeIsEmptyException);
+  EXPECT_THROW({ ring.pop_front(); }, RingDequeIsEmptyException);
+  EXPECT_THROW({ ring.front(); }, RingDequeIsEmptyException);
+  EXPECT_THROW({ ring.back(); }, RingDequeIsEmptyException);
+}
+
+TEST(RingDequeTests, NonTrivialElements) {
+  RingDeque<std::unique_ptr<std::string>, 8, RingOverflow::OVERWRITE> ring;
+  for (int i = 0; i < 20; ++i) {
+    ring.emplace_back(new std::string(std::to_string(i)));
+  }
+  ASSERT_EQ(*ring.front(), "12");
+  ring.pop_back();
+  ASSERT_EQ(*ring.back(), "18");
+  ring.clear();
+  ASSERT_TRUE(ring.is_empty());
+}
+
+TEST(RingDequeTests, CopyAndMove) {
+  RingDeque<std::string> ring(4);
+  ring.push_back("b");
+  ring.push_front("a");
+  RingDeque<std::string> copy = ring;
+  ASSERT_EQ(copy.size(), 2);
+  ASSERT_EQ(copy[0], "a");
+  ASSERT_EQ(copy[1], "b");
+  RingDeque<std::string> moved = std::move(ring);
+  ASSERT_EQ(moved.size(), 2);
+  ASSERT_EQ(ring.size(), 0);
+  ring.push_back("c");
+  ASSERT_EQ(ring.front(), "c");
+  copy = ring;
+  ASSERT_EQ(copy.size(), 1);
+  ASSERT_EQ(copy.back(), "c");
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
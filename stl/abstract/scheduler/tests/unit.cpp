@@ -0,0 +1,145 @@
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../thread_pool.hpp"
+#include "../work_stealing_deque.hpp"
+
+TEST(WorkStealingDequeTests, OwnerIsLifoThiefIsFifo) {
+  WorkStealingDeque<int> deque;
+  for (int i = 0; i < 1000; ++i) {
+    deque.push(i);
+  }
+  ASSERT_EQ(deque.size(), 1000);
+  int value = -1;
+  ASSERT_TRUE(deque.take(value));
+  ASSERT_EQ(value, 999);
+  ASSERT_TRUE(deque.steal(value));
+  ASSERT_EQ(value, 0);
+  for (int i = 998; i >= 1; --i) {
+    ASSERT_TRUE(deque.take(value));
+    ASSERT_EQ(value, i);
+  }
+  ASSERT_FALSE(deque.take(value));
+  ASSERT_FALSE(deque.steal(value));
+  ASSERT_TRUE(deque.is_empty());
+}
+
+TEST(WorkStealingDequeTests, ConcurrentThieves) {
+  const int count = 200000;
+  const int thieves = 3;
+  WorkStealingDeque<int> deque;
+  std::vector<std::atomic<int>> seen(count);
+  std::atomic<bool> done{false};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thieves; ++t) {
+    threads.emplace_back([&] {
+      int value = 0;
+      while (!done.load()) {
+        if (deque.steal(value)) {
+          seen[value].fetch_add(1);
+        }
+      }
+    });
+  }
+  int value = 0;
+  for (int i = 0; i < count; ++i) {
+    deque.push(i);
+    if (i % 3 == 0 && deque.take(value)) {
+      seen[value].fetch_add(1);
+    }
+  }
+  while (deque.take(value)) {
+    seen[value].fetch_add(1);
+  }
+  done = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (int i = 0; i < count; ++i) {
+    ASSERT_EQ(seen[i].load(), 1) << i;
+  }
+}
+
+TEST(ThreadPoolTests, ParallelFor) {
+  ThreadPool pool(4);
+  std::vector<int> data(1000000, 0);
+  pool.parallel_for(0, data.size(), 1024, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      data[i] = static_cast<int>(i % 7);
+    }
+  });
+  for (size_t i = 0; i < data.size(); ++i) {
+    ASSERT_EQ(data[i], static_cast<int>(i % 7));
+  }
+  pool.parallel_for(5, 5, 16, [&](size_t, size_t) { FAIL(); });
+}
+
+long long Fib(ThreadPool &pool, int n) {
+  if (n < 16) {
+    return n < 2 ? n : Fib(pool, n - 1) + Fib(pool, n - 2);
+  }
+  long long left = 0;
+  TaskGroup group(pool);
+  group.spawn([&] { left = Fib(pool, n - 1); });
+  long long right = Fib(pool, n - 2);
+  group.wait();
+  return left + right;
+}
+
+TEST(ThreadPoolTests, NestedForkJoin) {
+  ThreadPool pool(4);
+  ASSERT_EQ(Fib(pool, 27), 196418);
+}
+
+TEST(ThreadPoolTests, SpawnFromOutside) {
+  ThreadPool pool(3);
+  std::atomic<int> sum{0};
+  TaskGroup group(pool);
+  for (int i = 1; i <= 1000; ++i) {
+    group.spawn([&sum, i] { sum += i; });
+  }
+  group.wait();
+  ASSERT_EQ(sum.load(), 500500);
+}
+
+TEST(ThreadPoolTests, ExceptionReachesWaiter) {
+  ThreadPool pool(2);
+  std::atomic<int> ran{0};
+  TaskGroup group(pool);
+  for (int i = 0; i < 100; ++i) {
+    group.spawn([&ran, i] {
+      ++ran;
+      if (i == 42) {
+        throw std::runtime_error("task failed");
+      }
+    });
+  }
+  EXPECT_THROW({ group.wait(); }, std::runtime_error);
+  ASSERT_EQ(ran.load(), 100);
+  group.spawn([&ran] { ++ran; });
+  group.wait();
+  ASSERT_EQ(ran.load(), 101);
+}
+
+TEST(ThreadPoolTests, IdleWorkersWakeUp) {
+  ThreadPool pool(4);
+  for (int round = 0; round < 50; ++round) {
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+    std::atomic<int> count{0};
+    pool.parallel_for(0, 64, 1, [&](size_t begin, size_t end) {
+      count += static_cast<int>(end - begin);
+    });
+    ASSERT_EQ(count.load(), 64);
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
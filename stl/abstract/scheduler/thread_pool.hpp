@@ -0,0 +1,301 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "work_stealing_deque.hpp"
+
+// Steal attempts over random victims before a worker considers sleeping.
+const size_t STEAL_ROUNDS = 4;
+
+class ThreadPool;
+
+// Fork-join scope: spawn() hands work to the pool, wait() returns once all of
+// it (including work spawned by that work) is done and rethrows the first
+// exception a task threw. The waiting thread runs tasks itself in the
+// meantime, so nested groups inside tasks do not starve the pool.
+class TaskGroup {
+public:
+  explicit TaskGroup(ThreadPool &pool) : pool_(pool), pending_(0) {}
+
+  TaskGroup(const TaskGroup &) = delete;
+
+  TaskGroup &operator=(const TaskGroup &) = delete;
+
+  // Waits for outstanding tasks; their exceptions are dropped here.
+  ~TaskGroup();
+
+  template <class F> void spawn(F &&fn);
+
+  void wait();
+
+private:
+  friend class ThreadPool;
+
+  void finish(std::exception_ptr error) {
+    if (error) {
+      std::lock_guard<std::mutex> lock(error_mutex_);
+      if (!error_) {
+        error_ = error;
+      }
+    }
+    pending_.fetch_sub(1, std::memory_order_acq_rel);
+  }
+
+private:
+  ThreadPool &pool_;
+  std::atomic<size_t> pending_;
+  std::mutex error_mutex_;
+  std::exception_ptr error_;
+};
+
+// Work-stealing thread pool. Each worker owns a WorkStealingDeque: tasks
+// spawned on a worker go to the bottom of its own deque and are taken back
+// LIFO, which keeps recursive work cache-hot, while idle workers steal the
+// oldest (largest) pieces from random victims. Tasks submitted from outside
+// the pool go through a small locked injection queue.
+//
+// Idle workers sleep on a condition variable. A worker announces itself in
+// sleepers_ before its last look for work and submitters check sleepers_
+// after publishing, so a task is never left behind while everyone sleeps;
+// epoch_ tells a sleeper that something was published since it looked.
+class ThreadPool {
+  struct Task {
+    std::function<void()> fn_;
+    TaskGroup *group_;
+  };
+
+  struct Worker {
+    WorkStealingDeque<Task *> deque_;
+  };
+
+  struct Context {
+    ThreadPool *pool_;
+    size_t index_;
+  };
+
+public:
+  // 0 means std::thread::hardware_concurrency().
+  explicit ThreadPool(size_t threads = 0)
+      : workers_(threads != 0 ? threads
+                              : std::max<size_t>(
+                                    1, std::thread::hardware_concurrency())),
+        sleepers_(0), epoch_(0), stop_(false) {
+    for (size_t i = 0; i < workers_.size(); ++i) {
+      workers_[i] = std::make_unique<Worker>();
+    }
+    for (size_t i = 0; i < workers_.size(); ++i) {
+      threads_.emplace_back([this, i] { this->run_worker(i); });
+    }
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  // Lets the workers finish whatever is queued, then joins them.
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      stop_ = true;
+    }
+    sleep_cv_.notify_all();
+    for (auto &thread : threads_) {
+      thread.join();
+    }
+  }
+
+  size_t size() const { return workers_.size(); }
+
+  // Calls fn(begin, end) over [first, last) cut into ranges of at most grain
+  // elements. Ranges are split in halves recursively, so thieves take big
+  // pieces and the owner keeps working on neighbouring indices.
+  template <class F>
+  void parallel_for(size_t first, size_t last, size_t grain, const F &fn) {
+    TaskGroup group(*this);
+    split(group, first, last, grain == 0 ? 1 : grain, fn);
+    group.wait();
+  }
+
+private:
+  friend class TaskGroup;
+
+  template <class F>
+  static void split(TaskGroup &group, size_t first, size_t last, size_t grain,
+                    const F &fn) {
+    while (last - first > grain) {
+      size_t mid = first + (last - first) / 2;
+      group.spawn([&group, mid, last, grain, &fn] {
+        split(group, mid, last, grain, fn);
+      });
+      last = mid;
+    }
+    if (first < last) {
+      fn(first, last);
+    }
+  }
+
+  void submit(Task *task) {
+    Context &context = current();
+    if (context.pool_ == this) {
+      workers_[context.index_]->deque_.push(task);
+    } else {
+      std::lock_guard<std::mutex> lock(inject_mutex_);
+      injected_.push_back(task);
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_relaxed) != 0) {
+      {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        epoch_.fetch_add(1, std::memory_order_relaxed);
+      }
+      sleep_cv_.notify_one();
+    }
+  }
+
+  // Runs one task if any can be found; used by workers and by waiters.
+  bool run_one() {
+    Context &context = current();
+    Task *task = nullptr;
+    if (context.pool_ == this) {
+      if (!workers_[context.index_]->deque_.take(task) &&
+          !this->find_task(context.index_, task)) {
+        return false;
+      }
+    } else if (!this->find_task(workers_.size(), task)) {
+      return false;
+    }
+    std::exception_ptr error;
+    try {
+      task->fn_();
+    } catch (...) {
+      error = std::current_exception();
+    }
+    TaskGroup *group = task->group_;
+    delete task;
+    group->finish(error);
+    return true;
+  }
+
+  // Looks in the injection queue, then steals from random victims other
+  // than self.
+  bool find_task(size_t self, Task *&task) {
+    {
+      std::lock_guard<std::mutex> lock(inject_mutex_);
+      if (!injected_.empty()) {
+        task = injected_.front();
+        injected_.pop_front();
+        return true;
+      }
+    }
+    size_t count = workers_.size();
+    uint64_t &seed = random_state();
+    for (size_t round = 0; round < STEAL_ROUNDS * count; ++round) {
+      seed ^= seed << 13;
+      seed ^= seed >> 7;
+      seed ^= seed << 17;
+      size_t victim = seed % count;
+      if (victim != self && workers_[victim]->deque_.steal(task)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void run_worker(size_t index) {
+    current() = Context{this, index};
+    while (true) {
+      if (this->run_one()) {
+        continue;
+      }
+      uint64_t seen = epoch_.load(std::memory_order_relaxed);
+      sleepers_.fetch_add(1, std::memory_order_seq_cst);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (this->run_one()) {
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(sleep_mutex_);
+      sleep_cv_.wait(lock, [&] {
+        return stop_ || epoch_.load(std::memory_order_relaxed) != seen;
+      });
+      sleepers_.fetch_sub(1, std::memory_order_relaxed);
+      if (stop_ && this->all_idle()) {
+        return;
+      }
+    }
+  }
+
+  bool all_idle() {
+    std::lock_guard<std::mutex> lock(inject_mutex_);
+    if (!injected_.empty()) {
+      return false;
+    }
+    for (auto &worker : workers_) {
+      if (!worker->deque_.is_empty()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static Context &current() {
+    static thread_local Context context{nullptr, 0};
+    return context;
+  }
+
+  static uint64_t &random_state() {
+    static thread_local uint64_t state =
+        std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+    return state;
+  }
+
+private:
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::thread> threads_;
+  std::mutex inject_mutex_;
+  std::deque<Task *> injected_;
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cv_;
+  std::atomic<size_t> sleepers_;
+  std::atomic<uint64_t> epoch_;
+  bool stop_;
+};
+
+template <class F> void TaskGroup::spawn(F &&fn) {
+  pending_.fetch_add(1, std::memory_order_relaxed);
+  pool_.submit(new ThreadPool::Task{std::forward<F>(fn), this});
+}
+
+inline void TaskGroup::wait() {
+  while (pending_.load(std::memory_order_acquire) != 0) {
+    if (!pool_.run_one()) {
+      std::this_thread::yield();
+    }
+  }
+  std::lock_guard<std::mutex> lock(error_mutex_);
+  if (error_) {
+    std::exception_ptr error = std::move(error_);
+    error_ = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
+inline TaskGroup::~TaskGroup() {
+  while (pending_.load(std::memory_order_acquire) != 0) {
+    if (!pool_.run_one()) {
+      std::this_thread::yield();
+    }
+  }
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "../../utils/cache_line.hpp"
+const size_t STEAL_INITIAL_CAP = 64;
+
+// Chase-Lev work-stealing deque, following the C11 formulation of Le, Pop,
+// Cohen and Zappa Nardelli. The owner thread pushes and takes at the bottom
+// like a stack; any other thread may steal the oldest element from the top.
+// Only the last element is contended, and that race is settled with a single
+// CAS on top_.
+//
+// The ring grows when full. Thieves may still be reading the old ring, so it
+// is retired rather than freed and released together with the deque.
+template <typename T> class WorkStealingDeque {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "elements are copied through std::atomic<T>");
+
+  struct Ring {
+    explicit Ring(size_t capacity)
+        : mask_(capacity - 1), slots_(new std::atomic<T>[capacity]) {}
+
+    ~Ring() { delete[] slots_; }
+
+    T get(int64_t pos) const {
+      return slots_[pos & mask_].load(std::memory_order_relaxed);
+    }
+
+    void put(int64_t pos, T val) {
+      slots_[pos & mask_].store(val, std::memory_order_relaxed);
+    }
+
+    size_t mask_;
+    std::atomic<T> *slots_;
+  };
+
+public:
+  WorkStealingDeque() : top_(0), bottom_(0) {
+    ring_.store(new Ring(STEAL_INITIAL_CAP), std::memory_order_relaxed);
+  }
+
+  WorkStealingDeque(const WorkStealingDeque &) = delete;
+
+  WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+  ~WorkStealingDeque() {
+    delete ring_.load(std::memory_order_relaxed);
+    for (Ring *ring : retired_) {
+      delete ring;
+    }
+  }
+
+  // Owner only.
+  void push(T val) {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    int64_t top = top_.load(std::memory_order_acquire);
+    Ring *ring = ring_.load(std::memory_order_relaxed);
+    if (bottom - top > static_cast<int64_t>(ring->mask_)) {
+      ring = this->grow(ring, top, bottom);
+    }
+    ring->put(bottom, val);
+    bottom_.store(bottom + 1, std::memory_order_release);
+  }
+
+  // Owner only. Takes the most recently pushed element.
+  bool take(T &out) {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    Ring *ring = ring_.load(std::memory_order_relaxed);
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = top_.load(std::memory_order_relaxed);
+    if (top > bottom) {
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return false;
+    }
+    out = ring->get(bottom);
+    if (top < bottom) {
+      return true;
+    }
+    // Last element: race the thieves for it.
+    bool won = top_.compare_exchange_strong(top, top + 1,
+                                            std::memory_order_seq_cst,
+                                            std::memory_order_relaxed);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return won;
+  }
+
+  // Any thread. Takes the oldest element; fails when the deque is empty or
+  // another thread got there first.
+  bool steal(T &out) {
+    int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom) {
+      return false;
+    }
+    Ring *ring = ring_.load(std::memory_order_acquire);
+    T val = ring->get(top);
+    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return false;
+    }
+    out = val;
+    return true;
+  }
+
+  // Only a snapshot while other threads are running.
+  size_t size() const {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    int64_t top = top_.load(std::memory_order_relaxed);
+    return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+  }
+
+  bool is_empty() const { return this->size() == 0; }
+
+private:
+  Ring *grow(Ring *ring, int64_t top, int64_t bottom) {
+    Ring *bigger = new Ring((ring->mask_ + 1) * 2);
+    for (int64_t pos = top; pos < bottom; ++pos) {
+      bigger->put(pos, ring->get(pos));
+    }
+    retired_.push_back(ring);
+    ring_.store(bigger, std::memory_order_release);
+    return bigger;
+  }
+
+private:
+  alignas(CACHE_LINE) std::atomic<int64_t> top_;
+  alignas(CACHE_LINE) std::atomic<int64_t> bottom_;
+  std::atomic<Ring *> ring_;
+  // Touched by the owner only.
+  std::vector<Ring *> retired_;
+};
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "../../utils/cache_line.hpp"
+#include "../deque/deque.hpp"
+
+// Unbounded single-producer/single-consumer queue. Storage is a singly linked
+// list of Deque-sized chunks: the producer fills the tail chunk and links a
+// new one when it runs out, the consumer drains the head chunk and hands it
+// back through a one-slot spare, so a steady stream allocates nothing.
+//
+// head_ and tail_ count every element ever popped/pushed; the chunk slot of a
+// position is `pos & CHUNK_MASK`. The producer publishes with a release store
+// to tail_, which also publishes the chunk links it wrote before it, and the
+// consumer only looks at elements below a tail_ it loaded with acquire.
+// Exactly one thread may push and exactly one thread may pop at a time.
+template <typename T, class Allocator = std::allocator<T>> class SpscQueue {
+public:
+  static constexpr size_t CHUNK_SHIFT = ChunkShift(sizeof(T));
+  static constexpr size_t CHUNK_SZ = size_t(1) << CHUNK_SHIFT;
+  static constexpr size_t CHUNK_MASK = CHUNK_SZ - 1;
+
+private:
+  struct Chunk {
+    alignas(T) unsigned char data_[sizeof(T) * CHUNK_SZ];
+    Chunk *next_;
+
+    T *slot(size_t pos) {
+      return std::launder(reinterpret_cast<T *>(data_)) + (pos & CHUNK_MASK);
+    }
+  };
+
+  using ChunkAllocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<Chunk>;
+
+public:
+  SpscQueue() : spare_(nullptr) {
+    Chunk *chunk = this->acquire_chunk();
+    producer_.chunk_ = chunk;
+    producer_.tail_.store(0, std::memory_order_relaxed);
+    consumer_.chunk_ = chunk;
+    consumer_.head_.store(0, std::memory_order_relaxed);
+    consumer_.cached_tail_ = 0;
+  }
+
+  SpscQueue(const SpscQueue &) = delete;
+
+  SpscQueue &operator=(const SpscQueue &) = delete;
+
+  ~SpscQueue() {
+    size_t head = consumer_.head_.load(std::memory_order_relaxed);
+    size_t tail = producer_.tail_.load(std::memory_order_relaxed);
+    Chunk *chunk = consumer_.chunk_;
+    for (; head != tail; ++head) {
+      if ((head & CHUNK_MASK) == 0 && head != 0) {
+        chunk = this->next_chunk(chunk);
+      }
+      std::allocator_traits<Allocator>::destroy(alloc_, chunk->slot(head));
+    }
+    while (chunk != nullptr) {
+      chunk = this->next_chunk(chunk);
+    }
+    Chunk *spare = spare_.load(std::memory_order_relaxed);
+    if (spare != nullptr) {
+      chunk_alloc_.deallocate(spare, 1);
+    }
+  }
+
+  // Producer side.
+
+  void push(const T &val) { this->emplace(val); }
+
+  void push(T &&val) { this->emplace(std::move(val)); }
+
+  template <class... Args> void emplace(Args &&...args) {
+    size_t tail = producer_.tail_.load(std::memory_order_relaxed);
+    this->construct_at(tail, std::forward<Args>(args)...);
+    producer_.tail_.store(tail + 1, std::memory_order_release);
+  }
+
+  // Copies count elements starting at first and publishes them with a single
+  // store. If a copy throws, the elements copied before it stay queued.
+  template <class InputIt> void push_n(InputIt first, size_t count) {
+    size_t tail = producer_.tail_.load(std::memory_order_relaxed);
+    size_t last = tail + count;
+    try {
+      for (; tail != last; ++tail, ++first) {
+        this->construct_at(tail, *first);
+      }
+    } catch (...) {
+      producer_.tail_.store(tail, std::memory_order_release);
+      throw;
+    }
+    producer_.tail_.store(tail, std::memory_order_release);
+  }
+
+  // Consumer side.
+
+  bool try_pop(T &out) {
+    size_t head = consumer_.head_.load(std::memory_order_relaxed);
+    if (head == consumer_.cached_tail_) {
+      consumer_.cached_tail_ = producer_.tail_.load(std::memory_order_acquire);
+      if (head == consumer_.cached_tail_) {
+        return false;
+      }
+    }
+    T *ptr = this->slot_at(head);
+    out = std::move(*ptr);
+    this->consume_at(head, ptr);
+    consumer_.head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Moves up to count elements into out and frees their slots with a single
+  // store. Returns how many elements were popped. If a move throws, the
+  // elements popped before it are freed and the failed one stays queued.
+  template <class OutputIt> size_t pop_n(OutputIt out, size_t count) {
+    size_t head = consumer_.head_.load(std::memory_order_relaxed);
+    if (consumer_.cached_tail_ - head < count) {
+      consumer_.cached_tail_ = producer_.tail_.load(std::memory_order_acquire);
+    }
+    size_t available = consumer_.cached_tail_ - head;
+    size_t last = head + (available < count ? available : count);
+    size_t popped = last - head;
+    try {
+      for (; head != last; ++head, ++out) {
+        T *ptr = this->slot_at(head);
+        *out = std::move(*ptr);
+        this->consume_at(head, ptr);
+      }
+    } catch (...) {
+      consumer_.head_.store(head, std::memory_order_release);
+      throw;
+    }
+    consumer_.head_.store(last, std::memory_order_release);
+    return popped;
+  }
+
+  // Either side; exact only while the other side is idle.
+
+  bool is_empty() const {
+    return consumer_.head_.load(std::memory_order_acquire) ==
+           producer_.tail_.load(std::memory_order_acquire);
+  }
+
+  size_t size() const {
+    size_t head = consumer_.head_.load(std::memory_order_acquire);
+    size_t tail = producer_.tail_.load(std::memory_order_acquire);
+    return tail - head;
+  }
+
+private:
+  // Builds the element for position pos, linking a new chunk when pos is the
+  // first slot of one. The chunk is linked only after the element is built,
+  // so a throwing constructor leaves the chain unchanged.
+  template <class... Args> void construct_at(size_t pos, Args &&...args) {
+    if ((pos & CHUNK_MASK) != 0 || pos == 0) {
+      std::allocator_traits<Allocator>::construct(
+          alloc_, producer_.chunk_->slot(pos), std::forward<Args>(args)...);
+      return;
+    }
+    Chunk *chunk = this->acquire_chunk();
+    try {
+      std::allocator_traits<Allocator>::construct(alloc_, chunk->slot(pos),
+                                                  std::forward<Args>(args)...);
+    } catch (...) {
+      this->release_chunk(chunk);
+      throw;
+    }
+    producer_.chunk_->next_ = chunk;
+    producer_.chunk_ = chunk;
+  }
+
+  // Returns the slot of position pos. The first slot of a chunk lives in the
+  // chunk after consumer_.chunk_, which consume_at steps to.
+  T *slot_at(size_t pos) {
+    Chunk *chunk = consumer_.chunk_;
+    if ((pos & CHUNK_MASK) == 0 && pos != 0) {
+      chunk = chunk->next_;
+    }
+    return chunk->slot(pos);
+  }
+
+  // Destroys the element at pos once it has been moved out, stepping to the
+  // next chunk (and recycling the drained one) when pos is the first slot of
+  // a chunk. Nothing changes until the move has succeeded, so a throwing
+  // move leaves the element and its chunk in place.
+  void consume_at(size_t pos, T *ptr) {
+    if ((pos & CHUNK_MASK) == 0 && pos != 0) {
+      Chunk *drained = consumer_.chunk_;
+      consumer_.chunk_ = drained->next_;
+      this->release_chunk(drained);
+    }
+    std::allocator_traits<Allocator>::destroy(alloc_, ptr);
+  }
+
+  Chunk *acquire_chunk() {
+    Chunk *chunk = spare_.exchange(nullptr, std::memory_order_acquire);
+    if (chunk == nullptr) {
+      chunk = chunk_alloc_.allocate(1);
+    }
+    chunk->next_ = nullptr;
+    return chunk;
+  }
+
+  void release_chunk(Chunk *chunk) {
+    Chunk *old = spare_.exchange(chunk, std::memory_order_acq_rel);
+    if (old != nullptr) {
+      chunk_alloc_.deallocate(old, 1);
+    }
+  }
+
+  Chunk *next_chunk(Chunk *chunk) {
+    Chunk *next = chunk->next_;
+    chunk_alloc_.deallocate(chunk, 1);
+    return next;
+  }
+
+private:
+  // Keeps the producer's and the consumer's hot fields on separate cache
+  // lines.
+  struct alignas(CACHE_LINE) Producer {
+    std::atomic<size_t> tail_;
+    Chunk *chunk_;
+  };
+
+  struct alignas(CACHE_LINE) Consumer {
+    std::atomic<size_t> head_;
+    Chunk *chunk_;
+    // Last tail_ the consumer saw; refreshed only when it runs dry.
+    size_t cached_tail_;
+  };
+
+  Producer producer_;
+  Consumer consumer_;
+  alignas(CACHE_LINE) std::atomic<Chunk *> spare_;
+  Allocator alloc_;
+  ChunkAllocator chunk_alloc_;
+};
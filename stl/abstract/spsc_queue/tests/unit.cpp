@@ -0,0 +1,217 @@
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../spsc_queue.hpp"
+
+// Refuses to be move-assigned from a negative value.
+struct Brittle {
+  explicit Brittle(int value) : value_(value) {}
+  Brittle(Brittle &&) = default;
+  Brittle &operator=(Brittle &&other) {
+    if (other.value_ < 0) {
+      throw std::runtime_error("negative");
+    }
+    value_ = other.value_;
+    return *this;
+  }
+  int value_;
+};
+
+std::vector<Brittle> MakeBatch(size_t count) {
+  std::vector<Brittle> batch;
+  batch.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    batch.emplace_back(-2);
+  }
+  return batch;
+}
+
+TEST(SpscQueueTests, DefaultConstructor) {
+  SpscQueue<int> queue;
+  int value = 0;
+  ASSERT_TRUE(queue.is_empty());
+  ASSERT_EQ(queue.size(), 0);
+  ASSERT_FALSE(queue.try_pop(value));
+}
+
+TEST(SpscQueueTests, FifoAcrossChunks) {
+  SpscQueue<int> queue;
+  const int count = 5 * SpscQueue<int>::CHUNK_SZ + 3;
+  for (int i = 0; i < count; ++i) {
+    queue.push(i);
+  }
+  ASSERT_EQ(queue.size(), count);
+  int value = -1;
+  for (int i = 0; i < count; ++i) {
+    ASSERT_TRUE(queue.try_pop(value));
+    ASSERT_EQ(value, i);
+  }
+  ASSERT_FALSE(queue.try_pop(value));
+}
+
+TEST(SpscQueueTests, InterleavedPushPop) {
+  SpscQueue<std::string> queue;
+  std::string value;
+  int next = 0;
+  for (int i = 0; i < 10000; ++i) {
+    queue.emplace(std::to_string(i));
+    if (i % 3 != 0) {
+      ASSERT_TRUE(queue.try_pop(value));
+      ASSERT_EQ(value, std::to_string(next++));
+    }
+  }
+  ASSERT_EQ(queue.size(), 10000 - next);
+}
+
+TEST(SpscQueueTests, Batches) {
+  SpscQueue<int> queue;
+  std::vector<int> input(3000);
+  for (int i = 0; i < 3000; ++i) {
+    input[i] = i;
+  }
+  queue.push_n(input.data(), input.size());
+  std::vector<int> output(1000);
+  int expected = 0;
+  while (true) {
+    size_t popped = queue.pop_n(output.data(), output.size());
+    if (popped == 0) {
+      break;
+    }
+    for (size_t i = 0; i < popped; ++i) {
+      ASSERT_EQ(output[i], expected++);
+    }
+  }
+  ASSERT_EQ(expected, 3000);
+}
+
+TEST(SpscQueueTests, DestructorReleasesElements) {
+  SpscQueue<std::unique_ptr<int>> queue;
+  for (int i = 0; i < 5000; ++i) {
+    queue.emplace(new int(i));
+  }
+  std::unique_ptr<int> value;
+  for (int i = 0; i < 2500; ++i) {
+    ASSERT_TRUE(queue.try_pop(value));
+    ASSERT_EQ(*value, i);
+  }
+}
+
+TEST(SpscQueueTests, ThrowingConstructorKeepsQueue) {
+  struct Fragile {
+    explicit Fragile(int value) : value_(value) {
+      if (value < 0) {
+        throw std::runtime_error("negative");
+      }
+    }
+    Fragile &operator=(Fragile &&) = default;
+    Fragile(Fragile &&) = default;
+    int value_;
+  };
+  SpscQueue<Fragile> queue;
+  const int chunk = SpscQueue<Fragile>::CHUNK_SZ;
+  for (int i = 0; i < chunk; ++i) {
+    queue.emplace(i);
+  }
+  EXPECT_THROW({ queue.emplace(-1); }, std::runtime_error);
+  queue.emplace(chunk);
+  Fragile value(0);
+  for (int i = 0; i <= chunk; ++i) {
+    ASSERT_TRUE(queue.try_pop(value));
+    ASSERT_EQ(value.value_, i);
+  }
+  ASSERT_FALSE(queue.try_pop(value));
+}
+
+TEST(SpscQueueTests, ThrowingMoveAtChunkBoundary) {
+  SpscQueue<Brittle> queue;
+  const int chunk = SpscQueue<Brittle>::CHUNK_SZ;
+  for (int i = 0; i < chunk; ++i) {
+    queue.emplace(i);
+  }
+  queue.emplace(-1);
+  for (int i = 1; i < 2 * chunk; ++i) {
+    queue.emplace(chunk + i);
+  }
+  Brittle value(0);
+  for (int i = 0; i < chunk; ++i) {
+    ASSERT_TRUE(queue.try_pop(value));
+  }
+  // The first element of the second chunk refuses to move, twice.
+  EXPECT_THROW({ queue.try_pop(value); }, std::runtime_error);
+  EXPECT_THROW({ queue.try_pop(value); }, std::runtime_error);
+  ASSERT_EQ(queue.size(), 2 * chunk);
+  // Producing more reuses only the chunks the consumer is done with.
+  for (int i = 2 * chunk; i < 3 * chunk; ++i) {
+    queue.emplace(chunk + i);
+  }
+  auto batch = MakeBatch(4);
+  EXPECT_THROW({ queue.pop_n(batch.begin(), batch.size()); },
+               std::runtime_error);
+  ASSERT_EQ(queue.size(), 3 * chunk);
+}
+
+TEST(SpscQueueTests, ThrowingMoveInBatchKeepsPopped) {
+  SpscQueue<Brittle> queue;
+  const int chunk = SpscQueue<Brittle>::CHUNK_SZ;
+  for (int i = 0; i < chunk + 2; ++i) {
+    queue.emplace(i == chunk + 1 ? -1 : i);
+  }
+  queue.emplace(chunk + 2);
+  auto batch = MakeBatch(chunk + 3);
+  EXPECT_THROW({ queue.pop_n(batch.begin(), batch.size()); },
+               std::runtime_error);
+  for (int i = 0; i <= chunk; ++i) {
+    ASSERT_EQ(batch[i].value_, i);
+  }
+  // Only the element that failed to move and the ones after it are left.
+  ASSERT_EQ(queue.size(), 2);
+  Brittle value(0);
+  EXPECT_THROW({ queue.try_pop(value); }, std::runtime_error);
+  ASSERT_EQ(queue.size(), 2);
+}
+
+TEST(SpscQueueTests, TwoThreads) {
+  SpscQueue<size_t> queue;
+  const size_t count = 1000000;
+  std::thread producer([&] {
+    size_t batch[64];
+    for (size_t i = 0; i < count;) {
+      if (i % 1000 < 500) {
+        queue.push(i++);
+        continue;
+      }
+      size_t n = 0;
+      for (; n < 64 && i < count; ++n) {
+        batch[n] = i++;
+      }
+      queue.push_n(batch, n);
+    }
+  });
+  size_t expected = 0;
+  size_t batch[32];
+  while (expected < count) {
+    if (expected % 2 == 0) {
+      size_t value = 0;
+      if (queue.try_pop(value)) {
+        ASSERT_EQ(value, expected++);
+      }
+      continue;
+    }
+    size_t popped = queue.pop_n(batch, 32);
+    for (size_t i = 0; i < popped; ++i) {
+      ASSERT_EQ(batch[i], expected++);
+    }
+  }
+  producer.join();
+  ASSERT_TRUE(queue.is_empty());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
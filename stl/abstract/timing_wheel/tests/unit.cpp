@@ -0,0 +1,150 @@
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../timing_wheel.hpp"
+
+struct Timer : TimerNode {
+  int id = 0;
+  uint64_t fired_at = 0;
+  int fired = 0;
+};
+
+TEST(TimingWheelTests, DefaultConstructor) {
+  TimingWheel wheel;
+  ASSERT_EQ(wheel.now(), 0);
+  ASSERT_TRUE(wheel.is_empty());
+  ASSERT_EQ(wheel.advance(1000, [](TimerNode &) { FAIL(); }), 0);
+  ASSERT_EQ(wheel.now(), 1000);
+}
+
+TEST(TimingWheelTests, FiresAtDeadline) {
+  TimingWheel wheel(100);
+  Timer timer;
+  wheel.schedule(timer, 150);
+  ASSERT_TRUE(timer.is_scheduled());
+  ASSERT_EQ(wheel.size(), 1);
+  auto record = [&](TimerNode &node) {
+    auto &t = static_cast<Timer &>(node);
+    t.fired_at = wheel.now();
+    ++t.fired;
+  };
+  ASSERT_EQ(wheel.advance(149, record), 0);
+  ASSERT_EQ(wheel.advance(200, record), 1);
+  ASSERT_EQ(timer.fired, 1);
+  ASSERT_EQ(timer.fired_at, 150);
+  ASSERT_FALSE(timer.is_scheduled());
+  ASSERT_TRUE(wheel.is_empty());
+}
+
+TEST(TimingWheelTests, PastDeadlineFiresNextTick) {
+  TimingWheel wheel(500);
+  Timer timer;
+  wheel.schedule(timer, 10);
+  ASSERT_EQ(timer.deadline(), 501);
+  ASSERT_EQ(wheel.advance(501, [](TimerNode &) {}), 1);
+}
+
+TEST(TimingWheelTests, RandomDeadlinesFireInOrder) {
+  const int count = 20000;
+  std::vector<std::unique_ptr<Timer>> timers;
+  TimingWheel wheel(12345);
+  std::mt19937_64 gen(5);
+  for (int i = 0; i < count; ++i) {
+    auto timer = std::make_unique<Timer>();
+    timer->id = i;
+    uint64_t span = i % 4 == 0 ? 20000000 : (i % 2 == 0 ? 300000 : 5000);
+    wheel.schedule(*timer, wheel.now() + 1 + gen() % span);
+    timers.push_back(std::move(timer));
+  }
+  uint64_t last = 0;
+  size_t fired = 0;
+  auto record = [&](TimerNode &node) {
+    auto &t = static_cast<Timer &>(node);
+    ASSERT_EQ(t.deadline(), wheel.now());
+    ASSERT_GE(wheel.now(), last);
+    last = wheel.now();
+    t.fired_at = wheel.now();
+    ++t.fired;
+  };
+  uint64_t now = wheel.now();
+  while (!wheel.is_empty()) {
+    now += gen() % 100000;
+    fired += wheel.advance(now, record);
+  }
+  ASSERT_EQ(fired, count);
+  for (auto &timer : timers) {
+    ASSERT_EQ(timer->fired, 1);
+    ASSERT_EQ(timer->fired_at, timer->deadline());
+  }
+}
+
+TEST(TimingWheelTests, FarFutureTimer) {
+  TimingWheel wheel;
+  Timer timer;
+  uint64_t deadline = 10 * WHEEL_RANGE + 77;
+  wheel.schedule(timer, deadline);
+  ASSERT_EQ(wheel.advance(deadline - 1, [](TimerNode &) { FAIL(); }), 0);
+  uint64_t fired_at = 0;
+  wheel.advance(deadline + 5, [&](TimerNode &) { fired_at = wheel.now(); });
+  ASSERT_EQ(fired_at, deadline);
+}
+
+TEST(TimingWheelTests, Cancel) {
+  TimingWheel wheel;
+  Timer first;
+  Timer second;
+  wheel.schedule(first, 70);
+  wheel.schedule(second, 70);
+  ASSERT_TRUE(wheel.cancel(first));
+  ASSERT_FALSE(wheel.cancel(first));
+  int fired = 0;
+  wheel.advance(100, [&](TimerNode &node) {
+    ASSERT_EQ(&node, &second);
+    ++fired;
+  });
+  ASSERT_EQ(fired, 1);
+  ASSERT_FALSE(wheel.cancel(second));
+}
+
+TEST(TimingWheelTests, CallbackReschedulesAndCancels) {
+  TimingWheel wheel;
+  Timer periodic;
+  Timer victim;
+  wheel.schedule(periodic, 10);
+  wheel.schedule(victim, 10);
+  int ticks = 0;
+  wheel.advance(1000, [&](TimerNode &node) {
+    if (&node == &periodic) {
+      ++ticks;
+      wheel.cancel(victim);
+      wheel.schedule(periodic, wheel.now() + 10);
+    } else {
+      FAIL();
+    }
+  });
+  ASSERT_EQ(ticks, 100);
+  ASSERT_EQ(periodic.deadline(), 1010);
+  ASSERT_TRUE(periodic.is_scheduled());
+  wheel.clear();
+  ASSERT_FALSE(periodic.is_scheduled());
+}
+
+TEST(TimingWheelTests, RescheduleMovesTimer) {
+  TimingWheel wheel;
+  Timer timer;
+  wheel.schedule(timer, 5000);
+  wheel.schedule(timer, 30);
+  ASSERT_EQ(wheel.size(), 1);
+  uint64_t fired_at = 0;
+  wheel.advance(10000, [&](TimerNode &) { fired_at = wheel.now(); });
+  ASSERT_EQ(fired_at, 30);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
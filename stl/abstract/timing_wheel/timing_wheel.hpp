@@ -0,0 +1,205 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+const size_t WHEEL_LEVELS = 4;
+const size_t WHEEL_SLOT_BITS = 6;
+const size_t WHEEL_SLOTS = size_t(1) << WHEEL_SLOT_BITS;
+const uint64_t WHEEL_SLOT_MASK = WHEEL_SLOTS - 1;
+// Deadlines further than this many ticks ahead are parked in the last level
+// and re-filed every time they cascade until they come into range.
+const uint64_t WHEEL_RANGE = uint64_t(1) << (WHEEL_LEVELS * WHEEL_SLOT_BITS);
+
+class TimingWheel;
+
+// Intrusive timer: embed or derive from it and recover the owner in the
+// advance() callback. The wheel never allocates or frees nodes; a node must
+// stay alive (and not move) while it is scheduled.
+class TimerNode {
+public:
+  TimerNode() : prev_(nullptr), next_(nullptr), deadline_(0), slot_(0) {}
+
+  TimerNode(const TimerNode &) = delete;
+
+  TimerNode &operator=(const TimerNode &) = delete;
+
+  uint64_t deadline() const { return deadline_; }
+
+  bool is_scheduled() const { return next_ != nullptr; }
+
+private:
+  friend class TimingWheel;
+
+  TimerNode *prev_;
+  TimerNode *next_;
+  uint64_t deadline_;
+  // level * WHEEL_SLOTS + slot of the list the node is linked into.
+  size_t slot_;
+};
+
+// Hierarchical timing wheel: WHEEL_LEVELS levels of WHEEL_SLOTS slots, level
+// l ticking once every WHEEL_SLOTS^l ticks. A timer is filed in the lowest
+// level whose span covers its distance from now, so schedule() and cancel()
+// are O(1). When level 0 wraps, the due slot of level 1 is emptied and its
+// timers are re-filed closer in, and so on upwards (as in the Linux kernel's
+// classic timer wheel). Each slot is a circular list with an embedded
+// sentinel, and a bitmap per level lets advance() jump over empty slots.
+class TimingWheel {
+public:
+  explicit TimingWheel(uint64_t now = 0) : now_(now), size_(0) {
+    for (size_t level = 0; level < WHEEL_LEVELS; ++level) {
+      occupied_[level] = 0;
+      for (size_t slot = 0; slot < WHEEL_SLOTS; ++slot) {
+        TimerNode &head = slots_[level][slot];
+        head.prev_ = &head;
+        head.next_ = &head;
+      }
+    }
+  }
+
+  TimingWheel(const TimingWheel &) = delete;
+
+  TimingWheel &operator=(const TimingWheel &) = delete;
+
+  // Leaves every node unscheduled.
+  ~TimingWheel() { this->clear(); }
+
+  // Fires the node at the first advance() that reaches deadline. Deadlines
+  // that are not in the future fire at the next tick. Scheduling a node that
+  // is already scheduled moves it.
+  void schedule(TimerNode &node, uint64_t deadline) {
+    if (node.is_scheduled()) {
+      this->unlink(node);
+    } else {
+      ++size_;
+    }
+    node.deadline_ = deadline > now_ ? deadline : now_ + 1;
+    this->file(node);
+  }
+
+  // Returns false if the node was not scheduled.
+  bool cancel(TimerNode &node) {
+    if (!node.is_scheduled()) {
+      return false;
+    }
+    this->unlink(node);
+    --size_;
+    return true;
+  }
+
+  // Moves time forward to now and calls fn(TimerNode &) for every timer
+  // whose deadline has been reached, in deadline order. The node is already
+  // unscheduled when fn runs, so fn may reschedule or destroy it and may
+  // schedule or cancel other timers. Returns how many timers fired.
+  template <class F> size_t advance(uint64_t now, F fn) {
+    size_t fired = 0;
+    while (now_ < now) {
+      now_ = this->next_tick(now);
+      if ((now_ & WHEEL_SLOT_MASK) == 0) {
+        this->cascade();
+      }
+      TimerNode &head = slots_[0][now_ & WHEEL_SLOT_MASK];
+      while (head.next_ != &head) {
+        TimerNode &node = *head.next_;
+        this->unlink(node);
+        --size_;
+        ++fired;
+        fn(node);
+      }
+    }
+    return fired;
+  }
+
+  uint64_t now() const { return now_; }
+
+  size_t size() const { return size_; }
+
+  bool is_empty() const { return size_ == 0; }
+
+  void clear() {
+    for (size_t level = 0; level < WHEEL_LEVELS; ++level) {
+      for (size_t slot = 0; slot < WHEEL_SLOTS; ++slot) {
+        TimerNode &head = slots_[level][slot];
+        while (head.next_ != &head) {
+          this->unlink(*head.next_);
+        }
+      }
+    }
+    size_ = 0;
+  }
+
+private:
+  // The next tick in (now_, limit] that has work: the next occupied slot of
+  // level 0, the next wrap of level 0, or limit itself.
+  uint64_t next_tick(uint64_t limit) const {
+    uint64_t wrap = (now_ | WHEEL_SLOT_MASK) + 1;
+    uint64_t target = limit < wrap ? limit : wrap;
+    size_t slot = now_ & WHEEL_SLOT_MASK;
+    uint64_t later = slot == WHEEL_SLOT_MASK
+                         ? 0
+                         : occupied_[0] & (~uint64_t(0) << (slot + 1));
+    if (later == 0) {
+      return target;
+    }
+    uint64_t tick = now_ - slot + __builtin_ctzll(later);
+    return tick < target ? tick : target;
+  }
+
+  // Called when level 0 wraps: empties the due slot of each level that
+  // wrapped as well and re-files its timers relative to now_.
+  void cascade() {
+    for (size_t level = 1; level < WHEEL_LEVELS; ++level) {
+      size_t slot = (now_ >> (level * WHEEL_SLOT_BITS)) & WHEEL_SLOT_MASK;
+      TimerNode &head = slots_[level][slot];
+      while (head.next_ != &head) {
+        TimerNode &node = *head.next_;
+        this->unlink(node);
+        this->file(node);
+      }
+      if (slot != 0) {
+        return;
+      }
+    }
+  }
+
+  void file(TimerNode &node) {
+    uint64_t deadline = node.deadline_;
+    uint64_t delta = deadline - now_;
+    if (delta >= WHEEL_RANGE) {
+      deadline = now_ + WHEEL_RANGE - 1;
+      delta = WHEEL_RANGE - 1;
+    }
+    size_t level = 0;
+    while (delta >= (uint64_t(1) << ((level + 1) * WHEEL_SLOT_BITS))) {
+      ++level;
+    }
+    size_t slot = (deadline >> (level * WHEEL_SLOT_BITS)) & WHEEL_SLOT_MASK;
+    TimerNode &head = slots_[level][slot];
+    node.slot_ = level * WHEEL_SLOTS + slot;
+    node.prev_ = head.prev_;
+    node.next_ = &head;
+    head.prev_->next_ = &node;
+    head.prev_ = &node;
+    occupied_[level] |= uint64_t(1) << slot;
+  }
+
+  void unlink(TimerNode &node) {
+    node.prev_->next_ = node.next_;
+    node.next_->prev_ = node.prev_;
+    if (node.prev_ == node.next_) {
+      size_t level = node.slot_ / WHEEL_SLOTS;
+      occupied_[level] &= ~(uint64_t(1) << (node.slot_ % WHEEL_SLOTS));
+    }
+    node.prev_ = nullptr;
+    node.next_ = nullptr;
+  }
+
+private:
+  static_assert(WHEEL_SLOTS == 64, "occupancy bitmaps are 64-bit words");
+
+  uint64_t now_;
+  size_t size_;
+  uint64_t occupied_[WHEEL_LEVELS];
+  TimerNode slots_[WHEEL_LEVELS][WHEEL_SLOTS];
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+
+// Open-addressing index from a key to the cache node that owns it. The key
+// itself lives only in the node (Node::key_); a slot keeps the node pointer
+// and the full hash so most probes are settled without touching the node.
+//
+// Linear probing over a power-of-two table kept at most half full. Erase
+// uses backward-shift deletion instead of tombstones, so probe sequences
+// never grow with churn.
+template <typename Node, typename Key, typename Hash, typename KeyEqual>
+class HashIndex {
+  struct Slot {
+    Node *node_;
+    size_t hash_;
+  };
+
+ public:
+  HashIndex() : slots_(nullptr), mask_(0), size_(0) {}
+
+  HashIndex(const HashIndex &) = delete;
+  HashIndex &operator=(const HashIndex &) = delete;
+
+  ~HashIndex() { delete[] slots_; }
+
+  inline size_t Size() const noexcept { return size_; }
+
+  Node *Find(const Key &key) const {
+    if (size_ == 0) {
+      return nullptr;
+    }
+    size_t hash = hash_(key);
+    for (size_t i = hash & mask_;; i = (i + 1) & mask_) {
+      const Slot &slot = slots_[i];
+      if (slot.node_ == nullptr) {
+        return nullptr;
+      }
+      if (slot.hash_ == hash && equal_(slot.node_->key_, key)) {
+        return slot.node_;
+      }
+    }
+  }
+
+  // The node's key must not be in the index yet.
+  void Insert(Node *node) {
+    if ((size_ + 1) * 2 > mask_ + 1) {
+      Rehash(mask_ == 0 ? 16 : (mask_ + 1) * 2);
+    }
+    Place(node, hash_(node->key_));
+    ++size_;
+  }
+
+  // The node must be in the index.
+  void Erase(Node *node) noexcept {
+    size_t i = hash_(node->key_) & mask_;
+    while (slots_[i].node_ != node) {
+      i = (i + 1) & mask_;
+    }
+    for (size_t j = (i + 1) & mask_; slots_[j].node_ != nullptr;
+         j = (j + 1) & mask_) {
+      // Slot j may fill the hole at i unless its home lies in (i, j].
+      size_t home = slots_[j].hash_ & mask_;
+      if (((j - home) & mask_) >= ((j - i) & mask_)) {
+        slots_[i] = slots_[j];
+        i = j;
+      }
+    }
+    slots_[i].node_ = nullptr;
+    --size_;
+  }
+
+  void Clear() noexcept {
+    for (size_t i = 0; mask_ != 0 && i <= mask_; ++i) {
+      slots_[i].node_ = nullptr;
+    }
+    size_ = 0;
+  }
+
+ private:
+  void Place(Node *node, size_t hash) noexcept {
+    size_t i = hash & mask_;
+    while (slots_[i].node_ != nullptr) {
+      i = (i + 1) & mask_;
+    }
+    slots_[i].node_ = node;
+    slots_[i].hash_ = hash;
+  }
+
+  void Rehash(size_t capacity) {
+    Slot *old = slots_;
+    size_t old_capacity = mask_ == 0 ? 0 : mask_ + 1;
+    slots_ = new Slot[capacity]();
+    mask_ = capacity - 1;
+    for (size_t i = 0; i < old_capacity; ++i) {
+      if (old[i].node_ != nullptr) {
+        Place(old[i].node_, old[i].hash_);
+      }
+    }
+    delete[] old;
+  }
+
+ private:
+  Slot *slots_;
+  size_t mask_;
+  size_t size_;
+  Hash hash_;
+  KeyEqual equal_;
+};
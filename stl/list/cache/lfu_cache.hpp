@@ -0,0 +1,202 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+#include "exceptions.hpp"
+#include "hash_index.hpp"
+#include "recency_list.hpp"
+
+// Bounded least-frequently-used cache with O(1) operations. Entries with the
+// same use count share a bucket; buckets form a list ordered by count, so the
+// victim is always at the back of the first bucket (least frequent, and the
+// least recent among those). A hit moves the entry into the next bucket,
+// creating it if the count is new.
+//
+// Capacity, charges and the eviction callback behave as in LruCache.
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class LfuCache {
+  struct Bucket;
+
+  struct Node {
+    Key key_;
+    Value value_;
+    size_t charge_;
+    Bucket *bucket_ = nullptr;
+    Node *prev_ = nullptr;
+    Node *next_ = nullptr;
+
+    Node(const Key &key, Value &&value, size_t charge)
+        : key_(key), value_(std::move(value)), charge_(charge) {}
+  };
+
+  struct Bucket {
+    size_t count_;
+    RecencyList<Node> entries_;
+    Bucket *prev_ = nullptr;
+    Bucket *next_ = nullptr;
+
+    explicit Bucket(size_t count) : count_(count) {}
+  };
+
+ public:
+  using EvictionCallback = std::function<void(const Key &, Value &)>;
+
+  explicit LfuCache(size_t capacity, EvictionCallback on_evict = nullptr)
+      : capacity_(capacity), charge_(0), on_evict_(std::move(on_evict)) {}
+
+  LfuCache(const LfuCache &) = delete;
+  LfuCache &operator=(const LfuCache &) = delete;
+
+  ~LfuCache() { Clear(); }
+
+  // Returns the cached value and counts a use, or nullptr.
+  Value *Get(const Key &key) {
+    Node *node = index_.Find(key);
+    if (node == nullptr) {
+      return nullptr;
+    }
+    Touch(node);
+    return &node->value_;
+  }
+
+  // Like Get, but does not count a use.
+  Value *Peek(const Key &key) const {
+    Node *node = index_.Find(key);
+    return node == nullptr ? nullptr : &node->value_;
+  }
+
+  inline bool Contains(const Key &key) const {
+    return index_.Find(key) != nullptr;
+  }
+
+  // Number of uses recorded for key, 0 if it is not cached.
+  size_t Frequency(const Key &key) const {
+    Node *node = index_.Find(key);
+    return node == nullptr ? 0 : node->bucket_->count_;
+  }
+
+  void Put(const Key &key, Value value, size_t charge = 1) {
+    if (charge > capacity_) {
+      throw CacheChargeTooLargeException("Entry does not fit into the cache");
+    }
+    Node *node = index_.Find(key);
+    if (node != nullptr) {
+      node->value_ = std::move(value);
+      charge_ = charge_ - node->charge_ + charge;
+      node->charge_ = charge;
+      Touch(node);
+    } else {
+      node = new Node(key, std::move(value), charge);
+      try {
+        index_.Insert(node);
+        if (buckets_.Front() == nullptr || buckets_.Front()->count_ != 1) {
+          buckets_.PushFront(new Bucket(1));
+        }
+      } catch (...) {
+        if (index_.Find(key) == node) {
+          index_.Erase(node);
+        }
+        delete node;
+        throw;
+      }
+      node->bucket_ = buckets_.Front();
+      node->bucket_->entries_.PushFront(node);
+      charge_ += charge;
+    }
+    EvictOverBudget(node);
+  }
+
+  bool Erase(const Key &key) {
+    Node *node = index_.Find(key);
+    if (node == nullptr) {
+      return false;
+    }
+    Remove(node);
+    return true;
+  }
+
+  // Shrinking the budget evicts right away.
+  void SetCapacity(size_t capacity) {
+    capacity_ = capacity;
+    EvictOverBudget(nullptr);
+  }
+
+  void Clear() noexcept {
+    while (!buckets_.IsEmpty()) {
+      Bucket *bucket = buckets_.Front();
+      while (!bucket->entries_.IsEmpty()) {
+        Node *node = bucket->entries_.Front();
+        bucket->entries_.Unlink(node);
+        delete node;
+      }
+      buckets_.Unlink(bucket);
+      delete bucket;
+    }
+    index_.Clear();
+    charge_ = 0;
+  }
+
+  inline size_t Size() const noexcept { return index_.Size(); }
+
+  inline bool IsEmpty() const noexcept { return index_.Size() == 0; }
+
+  inline size_t Charge() const noexcept { return charge_; }
+
+  inline size_t Capacity() const noexcept { return capacity_; }
+
+ private:
+  void Touch(Node *node) {
+    Bucket *bucket = node->bucket_;
+    Bucket *next = bucket->next_;
+    if (next == nullptr || next->count_ != bucket->count_ + 1) {
+      next = new Bucket(bucket->count_ + 1);
+      buckets_.InsertAfter(bucket, next);
+    }
+    bucket->entries_.Unlink(node);
+    next->entries_.PushFront(node);
+    node->bucket_ = next;
+    DropIfEmpty(bucket);
+  }
+
+  void DropIfEmpty(Bucket *bucket) noexcept {
+    if (bucket->entries_.IsEmpty()) {
+      buckets_.Unlink(bucket);
+      delete bucket;
+    }
+  }
+
+  // Evicts until the budget holds; keep (the entry just written) is spared.
+  void EvictOverBudget(Node *keep) {
+    while (charge_ > capacity_) {
+      Bucket *bucket = buckets_.Front();
+      Node *victim = bucket->entries_.Back();
+      if (victim == keep) {
+        victim = victim->prev_ != nullptr ? victim->prev_
+                                          : bucket->next_->entries_.Back();
+      }
+      if (on_evict_) {
+        on_evict_(victim->key_, victim->value_);
+      }
+      Remove(victim);
+    }
+  }
+
+  void Remove(Node *node) noexcept {
+    Bucket *bucket = node->bucket_;
+    index_.Erase(node);
+    bucket->entries_.Unlink(node);
+    charge_ -= node->charge_;
+    delete node;
+    DropIfEmpty(bucket);
+  }
+
+ private:
+  RecencyList<Bucket> buckets_;
+  HashIndex<Node, Key, Hash, KeyEqual> index_;
+  size_t capacity_;
+  size_t charge_;
+  EvictionCallback on_evict_;
+};
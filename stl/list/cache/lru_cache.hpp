@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+#include "exceptions.hpp"
+#include "hash_index.hpp"
+#include "recency_list.hpp"
+
+// Bounded least-recently-used cache. Entries sit on a recency list (most
+// recent at the front) and are found through an open-addressing index, so
+// Get, Put and eviction are all O(1).
+//
+// Capacity is a budget in charge units: every entry carries a charge (1 by
+// default, or e.g. its size in bytes) and Put evicts from the back of the
+// list until the total fits. The eviction callback runs only for entries
+// pushed out by the budget, not for Erase, Clear or a Put that replaces a
+// value.
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class LruCache {
+  struct Node {
+    Key key_;
+    Value value_;
+    size_t charge_;
+    Node *prev_ = nullptr;
+    Node *next_ = nullptr;
+
+    Node(const Key &key, Value &&value, size_t charge)
+        : key_(key), value_(std::move(value)), charge_(charge) {}
+  };
+
+ public:
+  using EvictionCallback = std::function<void(const Key &, Value &)>;
+
+  explicit LruCache(size_t capacity, EvictionCallback on_evict = nullptr)
+      : capacity_(capacity), charge_(0), on_evict_(std::move(on_evict)) {}
+
+  LruCache(const LruCache &) = delete;
+  LruCache &operator=(const LruCache &) = delete;
+
+  ~LruCache() { Clear(); }
+
+  // Returns the cached value and marks it most recently used, or nullptr.
+  Value *Get(const Key &key) {
+    Node *node = index_.Find(key);
+    if (node == nullptr) {
+      return nullptr;
+    }
+    list_.MoveToFront(node);
+    return &node->value_;
+  }
+
+  // Like Get, but leaves the recency order alone.
+  Value *Peek(const Key &key) const {
+    Node *node = index_.Find(key);
+    return node == nullptr ? nullptr : &node->value_;
+  }
+
+  inline bool Contains(const Key &key) const {
+    return index_.Find(key) != nullptr;
+  }
+
+  void Put(const Key &key, Value value, size_t charge = 1) {
+    if (charge > capacity_) {
+      throw CacheChargeTooLargeException("Entry does not fit into the cache");
+    }
+    Node *node = index_.Find(key);
+    if (node != nullptr) {
+      node->value_ = std::move(value);
+      charge_ = charge_ - node->charge_ + charge;
+      node->charge_ = charge;
+      list_.MoveToFront(node);
+    } else {
+      node = new Node(key, std::move(value), charge);
+      try {
+        index_.Insert(node);
+      } catch (...) {
+        delete node;
+        throw;
+      }
+      list_.PushFront(node);
+      charge_ += charge;
+    }
+    EvictOverBudget();
+  }
+
+  bool Erase(const Key &key) {
+    Node *node = index_.Find(key);
+    if (node == nullptr) {
+      return false;
+    }
+    Remove(node);
+    return true;
+  }
+
+  // Shrinking the budget evicts right away.
+  void SetCapacity(size_t capacity) {
+    capacity_ = capacity;
+    EvictOverBudget();
+  }
+
+  void Clear() noexcept {
+    while (!list_.IsEmpty()) {
+      Node *node = list_.Front();
+      list_.Unlink(node);
+      delete node;
+    }
+    index_.Clear();
+    charge_ = 0;
+  }
+
+  inline size_t Size() const noexcept { return index_.Size(); }
+
+  inline bool IsEmpty() const noexcept { return index_.Size() == 0; }
+
+  inline size_t Charge() const noexcept { return charge_; }
+
+  inline size_t Capacity() const noexcept { return capacity_; }
+
+ private:
+  void EvictOverBudget() {
+    while (charge_ > capacity_) {
+      Node *victim = list_.Back();
+      if (on_evict_) {
+        on_evict_(victim->key_, victim->value_);
+      }
+      Remove(victim);
+    }
+  }
+
+  void Remove(Node *node) noexcept {
+    index_.Erase(node);
+    list_.Unlink(node);
+    charge_ -= node->charge_;
+    delete node;
+  }
+
+ private:
+  RecencyList<Node> list_;
+  HashIndex<Node, Key, Hash, KeyEqual> index_;
+  size_t capacity_;
+  size_t charge_;
+  EvictionCallback on_evict_;
+};
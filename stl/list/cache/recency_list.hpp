@@ -0,0 +1,62 @@
+#pragma once
+
+// Doubly linked list threaded through the cache entries themselves. Same
+// layout as List: head_ and tail_ with nullptr at both ends, except that the
+// prev_/next_ links are members of Node so an entry found through the index
+// can be unlinked and moved to the front in O(1).
+template <typename Node> class RecencyList {
+ public:
+  inline Node *Front() const noexcept { return head_; }
+
+  inline Node *Back() const noexcept { return tail_; }
+
+  inline bool IsEmpty() const noexcept { return head_ == nullptr; }
+
+  void PushFront(Node *node) noexcept {
+    node->prev_ = nullptr;
+    node->next_ = head_;
+    if (head_ != nullptr) {
+      head_->prev_ = node;
+    } else {
+      tail_ = node;
+    }
+    head_ = node;
+  }
+
+  void InsertAfter(Node *pos, Node *node) noexcept {
+    node->prev_ = pos;
+    node->next_ = pos->next_;
+    if (pos->next_ != nullptr) {
+      pos->next_->prev_ = node;
+    } else {
+      tail_ = node;
+    }
+    pos->next_ = node;
+  }
+
+  void Unlink(Node *node) noexcept {
+    if (node->prev_ != nullptr) {
+      node->prev_->next_ = node->next_;
+    } else {
+      head_ = node->next_;
+    }
+    if (node->next_ != nullptr) {
+      node->next_->prev_ = node->prev_;
+    } else {
+      tail_ = node->prev_;
+    }
+    node->prev_ = nullptr;
+    node->next_ = nullptr;
+  }
+
+  void MoveToFront(Node *node) noexcept {
+    if (node != head_) {
+      Unlink(node);
+      PushFront(node);
+    }
+  }
+
+ private:
+  Node *head_ = nullptr;
+  Node *tail_ = nullptr;
+};
@@ -0,0 +1,227 @@
+#include <cstddef>
+#include <list>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../lfu_cache.hpp"
+#include "../lru_cache.hpp"
+
+// Hash that sends every key to one bucket, to exercise long probe runs.
+struct CollidingHash {
+  size_t operator()(int) const { return 0; }
+};
+
+TEST(LruCacheTests, GetAndPut) {
+  LruCache<int, std::string> cache(3);
+  ASSERT_TRUE(cache.IsEmpty());
+  ASSERT_EQ(cache.Get(1), nullptr);
+  cache.Put(1, "one");
+  cache.Put(2, "two");
+  ASSERT_EQ(*cache.Get(1), "one");
+  ASSERT_EQ(*cache.Get(2), "two");
+  cache.Put(1, "uno");
+  ASSERT_EQ(*cache.Get(1), "uno");
+  ASSERT_EQ(cache.Size(), 2);
+  ASSERT_EQ(cache.Charge(), 2);
+}
+
+TEST(LruCacheTests, EvictsLeastRecentlyUsed) {
+  std::vector<int> evicted;
+  LruCache<int, int> cache(
+      3, [&](const int &key, int & /*value*/) { evicted.push_back(key); });
+  cache.Put(1, 10);
+  cache.Put(2, 20);
+  cache.Put(3, 30);
+  cache.Get(1);
+  cache.Put(4, 40);
+  ASSERT_EQ(evicted, std::vector<int>{2});
+  ASSERT_FALSE(cache.Contains(2));
+  // Peek does not refresh 3, so it goes next.
+  cache.Peek(3);
+  cache.Put(5, 50);
+  ASSERT_EQ(evicted, (std::vector<int>{2, 3}));
+  ASSERT_TRUE(cache.Contains(1));
+  ASSERT_TRUE(cache.Contains(4));
+  ASSERT_TRUE(cache.Contains(5));
+}
+
+TEST(LruCacheTests, EraseAndClearSkipCallback) {
+  int calls = 0;
+  LruCache<int, int> cache(2, [&](const int &, int &) { ++calls; });
+  cache.Put(1, 1);
+  cache.Put(2, 2);
+  ASSERT_TRUE(cache.Erase(1));
+  ASSERT_FALSE(cache.Erase(1));
+  cache.Clear();
+  ASSERT_TRUE(cache.IsEmpty());
+  ASSERT_EQ(cache.Charge(), 0);
+  ASSERT_EQ(calls, 0);
+}
+
+TEST(LruCacheTests, ChargeBudget) {
+  LruCache<std::string, std::string> cache(10);
+  cache.Put("a", "aaaa", 4);
+  cache.Put("b", "bbbb", 4);
+  ASSERT_EQ(cache.Charge(), 8);
+  cache.Put("c", "cccccc", 6);
+  ASSERT_FALSE(cache.Contains("a"));
+  ASSERT_TRUE(cache.Contains("b"));
+  ASSERT_EQ(cache.Charge(), 10);
+  EXPECT_THROW({ cache.Put("d", "", 11); }, CacheChargeTooLargeException);
+  cache.Put("e", "e", 1);
+  ASSERT_FALSE(cache.Contains("b"));
+  ASSERT_EQ(cache.Charge(), 7);
+  cache.SetCapacity(6);
+  ASSERT_EQ(cache.Charge(), 1);
+  ASSERT_TRUE(cache.Contains("e"));
+}
+
+TEST(LruCacheTests, RandomAgainstModel) {
+  LruCache<int, int, CollidingHash> cache(64);
+  std::list<std::pair<int, int>> model;
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> key_dist(0, 199);
+  std::uniform_int_distribution<int> op_dist(0, 3);
+  for (int step = 0; step < 50000; ++step) {
+    int key = key_dist(gen);
+    int op = op_dist(gen);
+    auto it = model.begin();
+    while (it != model.end() && it->first != key) {
+      ++it;
+    }
+    if (op == 0) {
+      ASSERT_EQ(cache.Erase(key), it != model.end());
+      if (it != model.end()) {
+        model.erase(it);
+      }
+    } else if (op == 1) {
+      int *value = cache.Get(key);
+      ASSERT_EQ(value != nullptr, it != model.end());
+      if (it != model.end()) {
+        ASSERT_EQ(*value, it->second);
+        model.splice(model.begin(), model, it);
+      }
+    } else {
+      cache.Put(key, step);
+      if (it != model.end()) {
+        model.erase(it);
+      }
+      model.emplace_front(key, step);
+      if (model.size() > 64) {
+        model.pop_back();
+      }
+    }
+    ASSERT_EQ(cache.Size(), model.size());
+  }
+  for (const auto &[key, value] : model) {
+    ASSERT_EQ(*cache.Peek(key), value);
+  }
+}
+
+TEST(LfuCacheTests, EvictsLeastFrequentlyUsed) {
+  std::vector<int> evicted;
+  LfuCache<int, int> cache(
+      3, [&](const int &key, int & /*value*/) { evicted.push_back(key); });
+  cache.Put(1, 10);
+  cache.Put(2, 20);
+  cache.Put(3, 30);
+  cache.Get(1);
+  cache.Get(1);
+  cache.Get(3);
+  ASSERT_EQ(cache.Frequency(1), 3);
+  ASSERT_EQ(cache.Frequency(2), 1);
+  ASSERT_EQ(cache.Frequency(4), 0);
+  cache.Put(4, 40);
+  ASSERT_EQ(evicted, std::vector<int>{2});
+  // 3 and 4 tie with 2 and 1 uses; 4 is the least frequent.
+  cache.Put(5, 50);
+  ASSERT_EQ(evicted, (std::vector<int>{2, 4}));
+  ASSERT_EQ(*cache.Peek(1), 10);
+  ASSERT_EQ(cache.Frequency(1), 3);
+}
+
+TEST(LfuCacheTests, TiesBreakByRecency) {
+  std::vector<int> evicted;
+  LfuCache<int, int> cache(
+      2, [&](const int &key, int & /*value*/) { evicted.push_back(key); });
+  cache.Put(1, 1);
+  cache.Put(2, 2);
+  cache.Get(1);
+  cache.Get(2);
+  cache.Put(3, 3);
+  ASSERT_EQ(evicted, std::vector<int>{1});
+}
+
+TEST(LfuCacheTests, UpdateSparesWrittenEntry) {
+  LfuCache<int, int> cache(4);
+  cache.Put(1, 1, 2);
+  cache.Get(1);
+  cache.Get(1);
+  cache.Put(2, 2, 2);
+  // Growing 2 pushes out 1 even though 2 is the least frequent.
+  cache.Put(2, 3, 3);
+  ASSERT_FALSE(cache.Contains(1));
+  ASSERT_EQ(*cache.Get(2), 3);
+  ASSERT_EQ(cache.Charge(), 3);
+  EXPECT_THROW({ cache.Put(3, 3, 5); }, CacheChargeTooLargeException);
+}
+
+TEST(LfuCacheTests, RandomAgainstModel) {
+  LfuCache<int, int, CollidingHash> cache(32);
+  // key -> (count, last use, value)
+  std::map<int, std::vector<int>> model;
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<int> key_dist(0, 99);
+  std::uniform_int_distribution<int> op_dist(0, 4);
+  for (int step = 0; step < 30000; ++step) {
+    int key = key_dist(gen);
+    int op = op_dist(gen);
+    auto it = model.find(key);
+    if (op == 0) {
+      ASSERT_EQ(cache.Erase(key), it != model.end());
+      if (it != model.end()) {
+        model.erase(it);
+      }
+    } else if (op < 3) {
+      int *value = cache.Get(key);
+      ASSERT_EQ(value != nullptr, it != model.end());
+      if (it != model.end()) {
+        ASSERT_EQ(*value, it->second[2]);
+        ++it->second[0];
+        it->second[1] = step;
+      }
+    } else if (it != model.end()) {
+      cache.Put(key, step);
+      it->second = {it->second[0] + 1, step, step};
+    } else {
+      if (model.size() == 32) {
+        auto victim = model.begin();
+        for (auto jt = model.begin(); jt != model.end(); ++jt) {
+          if (jt->second[0] < victim->second[0] ||
+              (jt->second[0] == victim->second[0] &&
+               jt->second[1] < victim->second[1])) {
+            victim = jt;
+          }
+        }
+        model.erase(victim);
+      }
+      cache.Put(key, step);
+      model[key] = {1, step, step};
+    }
+    ASSERT_EQ(cache.Size(), model.size());
+  }
+  for (const auto &[key, state] : model) {
+    ASSERT_EQ(cache.Frequency(key), static_cast<size_t>(state[0]));
+    ASSERT_EQ(*cache.Peek(key), state[2]);
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,408 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "exceptions.hpp"
+
+// Doubly linked list whose nodes live in one growable array and link to each
+// other by 32-bit slot index instead of by pointer. A List<int> node spends
+// 16 bytes on links for 4 bytes of payload; here it is 8, and neighbours
+// allocated together sit next to each other in memory.
+//
+// Slot 0 is the sentinel (End()); it holds no element. Erased slots go on a
+// free list threaded through next_ and are reused before the array grows.
+// Growing moves the elements into a bigger array, which invalidates
+// references to them, but not iterators: an iterator is a slot index.
+template <typename T> class CompactList {
+  struct Slot {
+    uint32_t next_;
+    uint32_t prev_;
+    alignas(T) unsigned char data_[sizeof(T)];
+
+    T *Value() { return std::launder(reinterpret_cast<T *>(data_)); }
+  };
+
+  // prev_ of a slot on the free list.
+  static constexpr uint32_t FREE = UINT32_MAX;
+  static constexpr uint32_t INITIAL_CAPACITY = 16;
+
+ public:
+  class ListIterator {
+   public:
+    // NOLINTNEXTLINE
+    using value_type = T;
+    // NOLINTNEXTLINE
+    using reference_type = value_type &;
+    // NOLINTNEXTLINE
+    using pointer_type = value_type *;
+    // NOLINTNEXTLINE
+    using difference_type = std::ptrdiff_t;
+    // NOLINTNEXTLINE
+    using iterator_category = std::bidirectional_iterator_tag;
+
+    inline bool operator==(const ListIterator &other) const {
+      return this->index_ == other.index_;
+    };
+    inline bool operator!=(const ListIterator &other) const {
+      return this->index_ != other.index_;
+    };
+
+    inline reference_type operator*() const {
+      return *list_->slots_[index_].Value();
+    };
+
+    inline pointer_type operator->() const {
+      return list_->slots_[index_].Value();
+    };
+
+    ListIterator &operator++() {
+      this->index_ = list_->slots_[index_].next_;
+      return *this;
+    };
+
+    ListIterator operator++(int) {
+      ListIterator new_iter(list_, index_);
+      this->index_ = list_->slots_[index_].next_;
+      return new_iter;
+    };
+
+    ListIterator &operator--() {
+      this->index_ = list_->slots_[index_].prev_;
+      return *this;
+    };
+
+    ListIterator operator--(int) {
+      ListIterator new_iter(list_, index_);
+      this->index_ = list_->slots_[index_].prev_;
+      return new_iter;
+    };
+
+   private:
+    friend class CompactList<T>;
+    ListIterator(const CompactList *list, uint32_t index)
+        : list_(list), index_(index) {}
+
+   private:
+    const CompactList *list_;
+    uint32_t index_;
+  };
+
+ public:
+  CompactList()
+      : slots_(nullptr), capacity_(0), used_(0), free_(0), size_(0) {}
+
+  CompactList(const std::initializer_list<T> &values) : CompactList() {
+    Reserve(values.size());
+    for (const auto &value : values) {
+      PushBack(value);
+    }
+  }
+
+  CompactList(const CompactList &other) : CompactList() {
+    Reserve(other.size_);
+    for (auto it = other.Begin(); it != other.End(); ++it) {
+      PushBack(*it);
+    }
+  }
+
+  CompactList(CompactList &&other) noexcept : CompactList() { Swap(other); }
+
+  CompactList &operator=(const CompactList &other) {
+    if (this != &other) {
+      Clear();
+      Reserve(other.size_);
+      for (auto it = other.Begin(); it != other.End(); ++it) {
+        PushBack(*it);
+      }
+    }
+    return *this;
+  }
+
+  CompactList &operator=(CompactList &&other) noexcept {
+    if (this != &other) {
+      Clear();
+      Swap(other);
+    }
+    return *this;
+  }
+
+  ~CompactList() {
+    Clear();
+    ::operator delete(slots_, std::align_val_t(alignof(Slot)));
+  }
+
+  ListIterator Begin() const noexcept {
+    return ListIterator(this, size_ == 0 ? 0 : slots_[0].next_);
+  }
+
+  ListIterator End() const noexcept { return ListIterator(this, 0); }
+
+  inline T &Front() const {
+    if (size_ == 0) {
+      throw ListIsEmptyException("List is empty");
+    }
+    return *slots_[slots_[0].next_].Value();
+  }
+
+  inline T &Back() const {
+    if (size_ == 0) {
+      throw ListIsEmptyException("List is empty");
+    }
+    return *slots_[slots_[0].prev_].Value();
+  }
+
+  inline bool IsEmpty() const noexcept { return (size_ == 0); }
+
+  inline size_t Size() const noexcept { return size_; }
+
+  // Elements that fit before the array has to grow again.
+  inline size_t Capacity() const noexcept {
+    return capacity_ == 0 ? 0 : capacity_ - 1;
+  }
+
+  void Reserve(size_t count) {
+    if (count >= UINT32_MAX - 1) {
+      throw ListIsFullException("List is full");
+    }
+    if (count + 1 > capacity_) {
+      Grow(static_cast<uint32_t>(count + 1));
+    }
+  }
+
+  void Swap(CompactList &other) noexcept {
+    std::swap(slots_, other.slots_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(used_, other.used_);
+    std::swap(free_, other.free_);
+    std::swap(size_, other.size_);
+  }
+
+  ListIterator Find(const T &value) const {
+    auto it = Begin();
+    while (it != End() && !(*it == value)) {
+      ++it;
+    }
+    return it;
+  }
+
+  ListIterator Insert(ListIterator pos, const T &value) {
+    return Emplace(pos, value);
+  }
+
+  ListIterator Insert(ListIterator pos, T &&value) {
+    return Emplace(pos, std::move(value));
+  }
+
+  // Builds the element in a free slot before pos and returns an iterator to
+  // it.
+  template <class... Args>
+  ListIterator Emplace(ListIterator pos, Args &&...args) {
+    uint32_t index = Acquire(std::forward<Args>(args)...);
+    Slot &slot = slots_[index];
+    uint32_t next = pos.index_;
+    uint32_t prev = slots_[next].prev_;
+    slot.next_ = next;
+    slot.prev_ = prev;
+    slots_[prev].next_ = index;
+    slots_[next].prev_ = index;
+    ++size_;
+    return ListIterator(this, index);
+  }
+
+  // Erases the element at pos and returns an iterator to the one after it.
+  ListIterator Erase(ListIterator pos) {
+    if (size_ == 0) {
+      throw ListIsEmptyException("List is empty");
+    }
+    uint32_t index = pos.index_;
+    Slot &slot = slots_[index];
+    uint32_t next = slot.next_;
+    slots_[slot.prev_].next_ = next;
+    slots_[next].prev_ = slot.prev_;
+    Release(index);
+    --size_;
+    return ListIterator(this, next);
+  }
+
+  void PushBack(const T &value) { EmplaceBack(value); }
+
+  void PushBack(T &&value) { EmplaceBack(std::move(value)); }
+
+  void PushFront(const T &value) { EmplaceFront(value); }
+
+  void PushFront(T &&value) { EmplaceFront(std::move(value)); }
+
+  template <class... Args> T &EmplaceBack(Args &&...args) {
+    return *Emplace(End(), std::forward<Args>(args)...);
+  }
+
+  template <class... Args> T &EmplaceFront(Args &&...args) {
+    return *Emplace(Begin(), std::forward<Args>(args)...);
+  }
+
+  void PopBack() {
+    if (size_ == 0) {
+      throw ListIsEmptyException("List is empty");
+    }
+    Erase(ListIterator(this, slots_[0].prev_));
+  }
+
+  void PopFront() {
+    if (size_ == 0) {
+      throw ListIsEmptyException("List is empty");
+    }
+    Erase(ListIterator(this, slots_[0].next_));
+  }
+
+  // Destroys every element but keeps the array for reuse.
+  void Clear() noexcept {
+    if (slots_ == nullptr) {
+      return;
+    }
+    for (uint32_t index = slots_[0].next_; index != 0;) {
+      uint32_t next = slots_[index].next_;
+      slots_[index].Value()->~T();
+      index = next;
+    }
+    slots_[0].next_ = 0;
+    slots_[0].prev_ = 0;
+    used_ = 1;
+    free_ = 0;
+    size_ = 0;
+  }
+
+ private:
+  // Returns a slot holding a new element built from args. The element is
+  // built before anything is moved, since args may refer to elements of
+  // this list.
+  template <class... Args> uint32_t Acquire(Args &&...args) {
+    if (free_ != 0) {
+      uint32_t index = free_;
+      ::new (static_cast<void *>(slots_[index].data_))
+          T(std::forward<Args>(args)...);
+      free_ = slots_[index].next_;
+      return index;
+    }
+    if (used_ < capacity_) {
+      ::new (static_cast<void *>(slots_[used_].data_))
+          T(std::forward<Args>(args)...);
+      return used_++;
+    }
+    if (capacity_ == UINT32_MAX) {
+      throw ListIsFullException("List is full");
+    }
+    uint32_t new_capacity =
+        capacity_ == 0 ? INITIAL_CAPACITY
+                       : (capacity_ > UINT32_MAX / 2 ? UINT32_MAX
+                                                     : capacity_ * 2);
+    Slot *fresh = Allocate(new_capacity);
+    uint32_t index = capacity_ == 0 ? 1 : used_;
+    try {
+      ::new (static_cast<void *>(fresh[index].data_))
+          T(std::forward<Args>(args)...);
+    } catch (...) {
+      ::operator delete(fresh, std::align_val_t(alignof(Slot)));
+      throw;
+    }
+    try {
+      Relocate(fresh);
+    } catch (...) {
+      fresh[index].Value()->~T();
+      ::operator delete(fresh, std::align_val_t(alignof(Slot)));
+      throw;
+    }
+    Adopt(fresh, new_capacity);
+    used_ = index + 1;
+    return index;
+  }
+
+  void Release(uint32_t index) noexcept {
+    slots_[index].Value()->~T();
+    slots_[index].prev_ = FREE;
+    slots_[index].next_ = free_;
+    free_ = index;
+  }
+
+  void Grow(uint32_t new_capacity) {
+    Slot *fresh = Allocate(new_capacity);
+    try {
+      Relocate(fresh);
+    } catch (...) {
+      ::operator delete(fresh, std::align_val_t(alignof(Slot)));
+      throw;
+    }
+    Adopt(fresh, new_capacity);
+  }
+
+  static Slot *Allocate(uint32_t capacity) {
+    return static_cast<Slot *>(::operator new(
+        sizeof(Slot) * capacity, std::align_val_t(alignof(Slot))));
+  }
+
+  // Copies the links of every used slot into fresh and moves the elements
+  // over (or copies them, if moving could throw). On an exception the
+  // elements built in fresh are destroyed and this list is unchanged.
+  void Relocate(Slot *fresh) {
+    if (slots_ == nullptr) {
+      fresh[0].next_ = 0;
+      fresh[0].prev_ = 0;
+      return;
+    }
+    if constexpr (std::is_trivially_copyable<T>::value) {
+      std::memcpy(static_cast<void *>(fresh), slots_, sizeof(Slot) * used_);
+    } else {
+      uint32_t index = 0;
+      try {
+        for (; index < used_; ++index) {
+          fresh[index].next_ = slots_[index].next_;
+          fresh[index].prev_ = slots_[index].prev_;
+          if (index != 0 && slots_[index].prev_ != FREE) {
+            ::new (static_cast<void *>(fresh[index].data_))
+                T(std::move_if_noexcept(*slots_[index].Value()));
+          }
+        }
+      } catch (...) {
+        while (index-- > 1) {
+          if (slots_[index].prev_ != FREE) {
+            fresh[index].Value()->~T();
+          }
+        }
+        throw;
+      }
+    }
+  }
+
+  // Switches to fresh, whose slots Relocate filled.
+  void Adopt(Slot *fresh, uint32_t new_capacity) noexcept {
+    if (slots_ != nullptr) {
+      if constexpr (!std::is_trivially_destructible<T>::value) {
+        for (uint32_t index = 1; index < used_; ++index) {
+          if (slots_[index].prev_ != FREE) {
+            slots_[index].Value()->~T();
+          }
+        }
+      }
+      ::operator delete(slots_, std::align_val_t(alignof(Slot)));
+    } else {
+      used_ = 1;
+    }
+    slots_ = fresh;
+    capacity_ = new_capacity;
+  }
+
+ private:
+  Slot *slots_;
+  uint32_t capacity_;
+  // Slots [0, used_) have been handed out at least once.
+  uint32_t used_;
+  // Head of the free list; 0 when empty.
+  uint32_t free_;
+  uint32_t size_;
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <exception>
+#include <string>
+
+#include "../list/exceptions.hpp"
+
+class ListIsFullException : std::exception {
+public:
+  explicit ListIsFullException(const std::string &text)
+      : error_message_(text) {}
+
+  const char *what() const noexcept override { return error_message_.data(); }
+
+private:
+  std::string_view error_message_;
+};
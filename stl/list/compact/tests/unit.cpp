@@ -0,0 +1,149 @@
+#include <list>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../compact_list.hpp"
+
+template <typename T> std::vector<T> ToVector(const CompactList<T> &list) {
+  std::vector<T> values;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    values.push_back(*it);
+  }
+  return values;
+}
+
+TEST(CompactListTests, DefaultConstructor) {
+  CompactList<int> list;
+  ASSERT_TRUE(list.IsEmpty());
+  ASSERT_EQ(list.Size(), 0);
+  ASSERT_TRUE(list.Begin() == list.End());
+  EXPECT_THROW({ list.Front(); }, ListIsEmptyException);
+  EXPECT_THROW({ list.PopBack(); }, ListIsEmptyException);
+  EXPECT_THROW({ list.PopFront(); }, ListIsEmptyException);
+}
+
+TEST(CompactListTests, PushAndIterate) {
+  CompactList<int> list;
+  for (int i = 0; i < 100; ++i) {
+    list.PushBack(i);
+    list.PushFront(-i - 1);
+  }
+  ASSERT_EQ(list.Size(), 200);
+  ASSERT_EQ(list.Front(), -100);
+  ASSERT_EQ(list.Back(), 99);
+  int expected = -100;
+  for (auto it = list.Begin(); it != list.End(); it++) {
+    ASSERT_EQ(*it, expected++);
+  }
+  auto it = list.End();
+  for (int value = 99; value >= -100; --value) {
+    --it;
+    ASSERT_EQ(*it, value);
+  }
+  ASSERT_TRUE(it == list.Begin());
+}
+
+TEST(CompactListTests, IteratorsSurviveGrowth) {
+  CompactList<std::string> list{"a", "b"};
+  auto it = ++list.Begin();
+  size_t capacity = list.Capacity();
+  for (int i = 0; i < 1000; ++i) {
+    list.PushBack(std::to_string(i));
+  }
+  ASSERT_GT(list.Capacity(), capacity);
+  ASSERT_EQ(*it, "b");
+  list.Insert(it, "between");
+  ASSERT_EQ(*(++list.Begin()), "between");
+}
+
+TEST(CompactListTests, ErasedSlotsAreReused) {
+  CompactList<int> list;
+  list.Reserve(100);
+  size_t capacity = list.Capacity();
+  ASSERT_GE(capacity, 100);
+  for (int round = 0; round < 50; ++round) {
+    for (int i = 0; i < 100; ++i) {
+      list.PushBack(i);
+    }
+    for (auto it = list.Begin(); it != list.End();) {
+      it = list.Erase(it);
+    }
+  }
+  ASSERT_TRUE(list.IsEmpty());
+  ASSERT_EQ(list.Capacity(), capacity);
+}
+
+TEST(CompactListTests, InsertAliasedValueWhileGrowing) {
+  CompactList<std::string> list;
+  list.PushBack(std::string(100, 'x'));
+  while (list.Size() < list.Capacity()) {
+    list.PushBack("y");
+  }
+  list.PushBack(list.Front());
+  ASSERT_EQ(list.Back(), std::string(100, 'x'));
+}
+
+TEST(CompactListTests, CopyMoveAndFind) {
+  CompactList<std::string> list{"a", "b", "c"};
+  CompactList<std::string> copy = list;
+  ASSERT_EQ(ToVector(copy), ToVector(list));
+  CompactList<std::string> moved = std::move(list);
+  ASSERT_TRUE(list.IsEmpty());
+  ASSERT_EQ(*moved.Find("b"), "b");
+  ASSERT_TRUE(moved.Find("z") == moved.End());
+  copy = moved;
+  copy.PopFront();
+  ASSERT_EQ(copy.Front(), "b");
+  list = std::move(copy);
+  ASSERT_EQ(ToVector(list), (std::vector<std::string>{"b", "c"}));
+  list.Clear();
+  list.PushBack("d");
+  ASSERT_EQ(list.Back(), "d");
+}
+
+TEST(CompactListTests, MoveOnlyElements) {
+  CompactList<std::unique_ptr<int>> list;
+  for (int i = 0; i < 100; ++i) {
+    list.EmplaceBack(new int(i));
+  }
+  list.PopFront();
+  ASSERT_EQ(**list.Begin(), 1);
+  ASSERT_EQ(*list.Back(), 99);
+}
+
+TEST(CompactListTests, RandomAgainstModel) {
+  CompactList<std::string> list;
+  std::list<std::string> model;
+  std::mt19937 gen(42);
+  std::bernoulli_distribution insert_dist(0.5);
+  for (int step = 0; step < 20000; ++step) {
+    size_t pos = gen() % (model.size() + 1);
+    auto it = list.Begin();
+    auto model_it = model.begin();
+    for (size_t i = 0; i < pos; ++i) {
+      ++it;
+      ++model_it;
+    }
+    if (model.size() < 30 || (insert_dist(gen) && pos < model.size())) {
+      std::string value = std::to_string(step);
+      ASSERT_EQ(*list.Insert(it, value), value);
+      model.insert(model_it, value);
+    } else if (pos < model.size()) {
+      auto next = list.Erase(it);
+      model_it = model.erase(model_it);
+      ASSERT_EQ(next == list.End(), model_it == model.end());
+    }
+  }
+  ASSERT_EQ(list.Size(), model.size());
+  ASSERT_EQ(ToVector(list),
+            std::vector<std::string>(model.begin(), model.end()));
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -9,19 +9,34 @@
 
 template <typename T> class ForwardList {
 private:
-  class Node {
+  // The link part of a node. before_begin_ is a bare NodeBase, so
+  // InsertAfter/EraseAfter work the same at the front as anywhere else and
+  // never have to look for the node their iterator already holds.
+  class NodeBase {
     friend class ForwardListIterator;
     friend class ForwardList;
 
-  private:
-    T data_;
-    Node *next_;
+  protected:
+    NodeBase *next_;
 
-    Node() : next_(nullptr) {}
+    NodeBase() : next_(nullptr) {}
+
+    explicit NodeBase(NodeBase *next) : next_(next) {}
+  };
 
-    explicit Node(T data) : Node() { this->data_ = data; }
+  class Node : public NodeBase {
+    friend class ForwardListIterator;
+    friend class ForwardList;
 
-    Node(T data, Node *next) : Node(data) { this->next_ = next; }
+  private:
+    T data_;
+
+    // The element is built once, in place, from whatever PushFront/Emplace*
+    // were given; T needs no default constructor unless ForwardList(size_t)
+    // is used.
+    template <class... Args>
+    explicit Node(Args &&...args)
+        : NodeBase(), data_(std::forward<Args>(args)...) {}
   };
 
 public:
@@ -46,7 +61,9 @@ public:
       return this->current_ != other.current_;
     };
 
-    inline reference_type operator*() const { return this->current_->data_; };
+    inline reference_type operator*() const {
+      return static_cast<Node *>(this->current_)->data_;
+    };
 
     ForwardListIterator &operator++() {
       this->current_ = this->current_->next_;
@@ -54,13 +71,14 @@ public:
     };
 
     ForwardListIterator operator++(int) {
+      ForwardListIterator old_iter(this->current_);
       this->current_ = this->current_->next_;
-      return ForwardListIterator(this->current_);
+      return old_iter;
     };
 
     pointer_type operator->() const {
       if (current_ != nullptr) {
-        return &(current_->data_);
+        return &(static_cast<Node *>(current_)->data_);
       } else {
         return nullptr;
       }
@@ -68,174 +86,206 @@ public:
 
   private:
     friend class ForwardList<T>;
-    explicit ForwardListIterator(Node *node_ptr) : current_(node_ptr) {}
+    explicit ForwardListIterator(NodeBase *node_ptr) : current_(node_ptr) {}
 
   private:
-    Node *current_;
+    NodeBase *current_;
   };
 
 public:
-  ForwardList() : head_(nullptr), size_(0) {}
+  ForwardList() : tail_(&before_begin_), size_(0) {}
 
   explicit ForwardList(size_t sz) : ForwardList() {
-    if (sz != 0) {
-      head_ = new Node();
-      ++size_;
-      Node *iter = head_;
-      for (size_t i = 1; i < sz; ++i) {
-        iter->next_ = new Node();
-        iter = iter->next_;
-        ++size_;
-      }
+    for (size_t i = 0; i < sz; ++i) {
+      EmplaceBack();
     }
   }
 
   ForwardList(const std::initializer_list<T> &values) : ForwardList() {
-    Node *iter = nullptr;
     for (const T &value : values) {
-      if (size_ == 0) {
-        head_ = new Node(value);
-        iter = head_;
-      } else {
-        iter->next_ = new Node(value);
-        iter = iter->next_;
-      }
-      ++size_;
+      PushBack(value);
     }
   }
 
   ForwardList(const ForwardList &other) : ForwardList() {
-    if (other.size_ > 0) {
-      head_ = new Node(other.head_->data_);
-      Node *self_iter = head_;
-      Node *other_iter = other.head_->next_;
-      ++size_;
-      while (other_iter != nullptr) {
-        self_iter->next_ = new Node(other_iter->data_);
-        self_iter = self_iter->next_;
-        other_iter = other_iter->next_;
-        ++size_;
-      }
+    for (NodeBase *iter = other.before_begin_.next_; iter != nullptr;
+         iter = iter->next_) {
+      PushBack(static_cast<Node *>(iter)->data_);
     }
   }
 
+  // Takes over other's nodes; other is left empty.
+  ForwardList(ForwardList &&other) noexcept : ForwardList() { Append(other); }
+
   ForwardList &operator=(const ForwardList &other) {
     if (this != &other) {
       Clear();
-      if (other.size_ > 0) {
-        head_ = new Node(other.head_->data_);
-        Node *self_iter = head_;
-        Node *other_iter = other.head_->next_;
-        ++size_;
-        while (other_iter != nullptr) {
-          self_iter->next_ = new Node(other_iter->data_);
-          self_iter = self_iter->next_;
-          other_iter = other_iter->next_;
-          ++size_;
-        }
+      for (NodeBase *iter = other.before_begin_.next_; iter != nullptr;
+           iter = iter->next_) {
+        PushBack(static_cast<Node *>(iter)->data_);
       }
     }
     return *this;
   }
 
+  ForwardList &operator=(ForwardList &&other) noexcept {
+    if (this != &other) {
+      Clear();
+      Append(other);
+    }
+    return *this;
+  }
+
+  // Position before the first element, for InsertAfter/EraseAfter at the
+  // front. Must not be dereferenced.
+  ForwardListIterator BeforeBegin() const noexcept {
+    return ForwardListIterator(const_cast<NodeBase *>(&before_begin_));
+  }
+
   ForwardListIterator Begin() const noexcept {
-    return ForwardListIterator(head_);
+    return ForwardListIterator(before_begin_.next_);
   }
 
   ForwardListIterator End() const noexcept {
-    Node *iter = nullptr;
-    if (size_ != 0) {
-      iter = head_;
-      while (iter != nullptr) {
-        iter = iter->next_;
-      }
+    return ForwardListIterator(nullptr);
+  }
+
+  inline T &Front() const {
+    if (size_ == 0) {
+      throw ListIsEmptyException("Value doesn`t exist");
     }
-    return ForwardListIterator(iter);
+    return static_cast<Node *>(before_begin_.next_)->data_;
   }
 
-  inline T &Front() const { return head_->data_; }
+  inline T &Back() const {
+    if (size_ == 0) {
+      throw ListIsEmptyException("Value doesn`t exist");
+    }
+    return static_cast<Node *>(tail_)->data_;
+  }
 
   inline bool IsEmpty() const noexcept { return size_ == 0; }
 
   inline size_t Size() const noexcept { return size_; }
 
   void Swap(ForwardList &a) {
-    std::swap(head_, a.head_);
+    std::swap(before_begin_.next_, a.before_begin_.next_);
+    std::swap(tail_, a.tail_);
     std::swap(size_, a.size_);
+    // An empty list's tail is its own sentinel, which does not move.
+    if (size_ == 0) {
+      tail_ = &before_begin_;
+    }
+    if (a.size_ == 0) {
+      a.tail_ = &a.before_begin_;
+    }
   }
 
-  void EraseAfter(ForwardListIterator pos) {
-    if (size_ > 1) {
-      Node *iter = head_;
-      while (iter != pos.current_) {
-        iter = iter->next_;
-      }
-      Node *cur_node = iter->next_;
-      iter->next_ = cur_node->next_;
-      delete cur_node;
-      --size_;
-    } else {
+  // Erases the element after pos and returns an iterator to the one that
+  // followed it.
+  ForwardListIterator EraseAfter(ForwardListIterator pos) {
+    NodeBase *prev = pos.current_;
+    if (prev == nullptr || prev->next_ == nullptr) {
       throw ListIsEmptyException("Value doesn`t exist");
     }
+    NodeBase *cur_node = prev->next_;
+    prev->next_ = cur_node->next_;
+    if (cur_node == tail_) {
+      tail_ = prev;
+    }
+    delete static_cast<Node *>(cur_node);
+    --size_;
+    return ForwardListIterator(prev->next_);
   }
 
-  void InsertAfter(ForwardListIterator pos, const T &value) {
-    Node *iter = head_;
-    while (iter != pos.current_) {
-      iter = iter->next_;
-    }
-    iter->next_ = new Node(value, iter->next_);
+  // Inserts value after pos and returns an iterator to it.
+  ForwardListIterator InsertAfter(ForwardListIterator pos, const T &value) {
+    return EmplaceAfter(pos, value);
+  }
 
-    ++size_;
+  ForwardListIterator InsertAfter(ForwardListIterator pos, T &&value) {
+    return EmplaceAfter(pos, std::move(value));
+  }
+
+  template <class... Args>
+  ForwardListIterator EmplaceAfter(ForwardListIterator pos, Args &&...args) {
+    Node *node = new Node(std::forward<Args>(args)...);
+    Link(pos.current_, node);
+    return ForwardListIterator(node);
   }
 
   ForwardListIterator Find(const T &value) const {
-    Node *iter = head_;
-    while (iter->data_ != value) {
+    NodeBase *iter = before_begin_.next_;
+    while (iter != nullptr && static_cast<Node *>(iter)->data_ != value) {
       iter = iter->next_;
     }
     return ForwardListIterator(iter);
   }
 
   void Clear() noexcept {
-    if (size_ != 0) {
-      Node *cur_node = head_->next_;
-      Node *nex_node = cur_node;
-      delete head_;
-      while (cur_node != nullptr) {
-        cur_node = cur_node->next_;
-        delete nex_node;
-        nex_node = cur_node;
-      }
-      head_ = nullptr;
-      size_ = 0;
+    NodeBase *cur_node = before_begin_.next_;
+    while (cur_node != nullptr) {
+      NodeBase *nex_node = cur_node->next_;
+      delete static_cast<Node *>(cur_node);
+      cur_node = nex_node;
     }
+    before_begin_.next_ = nullptr;
+    tail_ = &before_begin_;
+    size_ = 0;
   }
 
-  void PushFront(const T &value) {
-    head_ = new Node(value, head_);
-    ++size_;
+  void PushFront(const T &value) { EmplaceFront(value); }
+
+  void PushFront(T &&value) { EmplaceFront(std::move(value)); }
+
+  void PushBack(const T &value) { EmplaceBack(value); }
+
+  void PushBack(T &&value) { EmplaceBack(std::move(value)); }
+
+  template <class... Args> T &EmplaceFront(Args &&...args) {
+    return *EmplaceAfter(BeforeBegin(), std::forward<Args>(args)...);
+  }
+
+  template <class... Args> T &EmplaceBack(Args &&...args) {
+    return *EmplaceAfter(ForwardListIterator(tail_),
+                         std::forward<Args>(args)...);
+  }
+
+  // Moves all elements of other to the end of this list in O(1).
+  void Append(ForwardList &other) noexcept {
+    if (this == &other || other.size_ == 0) {
+      return;
+    }
+    tail_->next_ = other.before_begin_.next_;
+    tail_ = other.tail_;
+    size_ += other.size_;
+    other.before_begin_.next_ = nullptr;
+    other.tail_ = &other.before_begin_;
+    other.size_ = 0;
   }
 
   void PopFront() {
-    if (size_ > 1) {
-      Node *cur_node = head_;
-      head_ = head_->next_;
-      delete cur_node;
-      --size_;
-    } else if (size_ == 1) {
-      delete head_;
-      head_ = nullptr;
-      --size_;
-    } else {
+    if (size_ == 0) {
       throw ListIsEmptyException("Value doesn`t exist");
     }
+    EraseAfter(BeforeBegin());
   }
 
   ~ForwardList() { Clear(); }
 
 private:
-  Node *head_;
+  void Link(NodeBase *prev, Node *node) noexcept {
+    node->next_ = prev->next_;
+    prev->next_ = node;
+    if (prev == tail_) {
+      tail_ = node;
+    }
+    ++size_;
+  }
+
+private:
+  NodeBase before_begin_;
+  NodeBase *tail_;
   size_t size_;
 };
 
@@ -244,4 +294,4 @@ namespace std {
 template <typename T> void Swap(ForwardList<T> &a, ForwardList<T> &b) {
   a.Swap(b);
 }
-} // namespace std
\ No newline at end of file
+} // namespace std
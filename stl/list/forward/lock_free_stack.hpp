@@ -0,0 +1,235 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "../../utils/cache_line.hpp"
+
+// Treiber stack: a ForwardList-style chain of nodes whose head is swapped in
+// with compare-and-swap, so any number of threads may push and pop at once.
+//
+// ABA protection: the head is one 64-bit word holding the node address in
+// the low 48 bits and a 16-bit tag in the high bits. Every successful swap
+// bumps the tag, so a pop that read head A, slept while A was popped and
+// pushed back, and then retries its CAS against the old word fails instead
+// of installing a stale next pointer. The tag wraps after 65536 swaps, which
+// a stalled thread would have to sleep through exactly to be fooled.
+//
+// Reclamation: a popped node goes to an internal free list (a second tagged
+// stack) and is reused by later pushes; memory goes back to the allocator
+// only in the destructor. A pop that loses the race may still read next_ of
+// a node that was popped meanwhile, and this keeps that read inside live
+// memory. next_ is atomic for the same reason.
+template <typename T> class LockFreeStack {
+  static_assert(sizeof(void *) == 8,
+                "the tag is packed above a 48-bit address");
+  static_assert(std::is_nothrow_move_constructible<T>::value,
+                "a popped node must always be emptied");
+
+  struct Node {
+    std::atomic<Node *> next_{nullptr};
+    alignas(T) unsigned char data_[sizeof(T)];
+
+    T *Value() { return std::launder(reinterpret_cast<T *>(data_)); }
+  };
+
+  // Tagged head of a chain of nodes.
+  class TaggedHead {
+    static constexpr unsigned TAG_SHIFT = 48;
+    static constexpr uint64_t POINTER_MASK = (uint64_t(1) << TAG_SHIFT) - 1;
+
+   public:
+    // Links the chain first..last (already connected through next_) on top.
+    void PushChain(Node *first, Node *last) noexcept {
+      uint64_t word = word_.load(std::memory_order_relaxed);
+      do {
+        last->next_.store(Pointer(word), std::memory_order_relaxed);
+      } while (!word_.compare_exchange_weak(word, Pack(first, word),
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed));
+    }
+
+    Node *Pop() noexcept {
+      uint64_t word = word_.load(std::memory_order_acquire);
+      while (Pointer(word) != nullptr) {
+        Node *next = Pointer(word)->next_.load(std::memory_order_relaxed);
+        if (word_.compare_exchange_weak(word, Pack(next, word),
+                                        std::memory_order_acquire,
+                                        std::memory_order_acquire)) {
+          return Pointer(word);
+        }
+      }
+      return nullptr;
+    }
+
+    // Detaches the whole chain.
+    Node *PopAll() noexcept {
+      uint64_t word = word_.load(std::memory_order_relaxed);
+      while (Pointer(word) != nullptr &&
+             !word_.compare_exchange_weak(word, Pack(nullptr, word),
+                                          std::memory_order_acquire,
+                                          std::memory_order_relaxed)) {
+      }
+      return Pointer(word);
+    }
+
+    bool IsEmpty() const noexcept {
+      return Pointer(word_.load(std::memory_order_acquire)) == nullptr;
+    }
+
+   private:
+    static Node *Pointer(uint64_t word) noexcept {
+      return reinterpret_cast<Node *>(word & POINTER_MASK);
+    }
+
+    // New word for node, with the tag of old advanced by one.
+    static uint64_t Pack(Node *node, uint64_t old) noexcept {
+      return ((old >> TAG_SHIFT) + 1) << TAG_SHIFT |
+             (reinterpret_cast<uint64_t>(node) & POINTER_MASK);
+    }
+
+   private:
+    std::atomic<uint64_t> word_{0};
+  };
+
+ public:
+  LockFreeStack() = default;
+
+  LockFreeStack(const LockFreeStack &) = delete;
+  LockFreeStack &operator=(const LockFreeStack &) = delete;
+
+  // Must not race with any other call.
+  ~LockFreeStack() {
+    Node *node = top_.PopAll();
+    while (node != nullptr) {
+      Node *next = node->next_.load(std::memory_order_relaxed);
+      node->Value()->~T();
+      delete node;
+      node = next;
+    }
+    node = free_.PopAll();
+    while (node != nullptr) {
+      Node *next = node->next_.load(std::memory_order_relaxed);
+      delete node;
+      node = next;
+    }
+  }
+
+  void Push(const T &value) { Emplace(value); }
+
+  void Push(T &&value) { Emplace(std::move(value)); }
+
+  template <class... Args> void Emplace(Args &&...args) {
+    Node *node = Acquire();
+    try {
+      ::new (static_cast<void *>(node->data_)) T(std::forward<Args>(args)...);
+    } catch (...) {
+      free_.PushChain(node, node);
+      throw;
+    }
+    top_.PushChain(node, node);
+  }
+
+  // Pushes [first, last) with a single swap of the head; the last value of
+  // the range ends up on top, as if pushed one by one.
+  template <class InputIt> void PushChain(InputIt first, InputIt last) {
+    Node *top = nullptr;
+    Node *bottom = nullptr;
+    try {
+      for (; first != last; ++first) {
+        Node *node = Acquire();
+        try {
+          ::new (static_cast<void *>(node->data_)) T(*first);
+        } catch (...) {
+          free_.PushChain(node, node);
+          throw;
+        }
+        node->next_.store(top, std::memory_order_relaxed);
+        top = node;
+        if (bottom == nullptr) {
+          bottom = node;
+        }
+      }
+    } catch (...) {
+      Release(top);
+      throw;
+    }
+    if (top != nullptr) {
+      top_.PushChain(top, bottom);
+    }
+  }
+
+  // Moves the top value into out. Returns false if the stack was empty. If
+  // the move-assignment throws, the value goes back on top of the stack.
+  bool Pop(T &out) {
+    Node *node = top_.Pop();
+    if (node == nullptr) {
+      return false;
+    }
+    try {
+      out = std::move(*node->Value());
+    } catch (...) {
+      top_.PushChain(node, node);
+      throw;
+    }
+    node->Value()->~T();
+    free_.PushChain(node, node);
+    return true;
+  }
+
+  // Detaches everything with one swap and hands the values to fn from the
+  // top down. Returns how many there were.
+  template <class F> size_t PopAll(F fn) {
+    Node *node = top_.PopAll();
+    Node *first = node;
+    size_t count = 0;
+    try {
+      for (; node != nullptr;
+           node = node->next_.load(std::memory_order_relaxed)) {
+        fn(std::move(*node->Value()));
+        ++count;
+      }
+    } catch (...) {
+      // Values not handed out yet are dropped with their nodes.
+      Release(first);
+      throw;
+    }
+    Release(first);
+    return count;
+  }
+
+  // Snapshot; may be stale by the time it returns.
+  inline bool IsEmpty() const noexcept { return top_.IsEmpty(); }
+
+ private:
+  Node *Acquire() {
+    Node *node = free_.Pop();
+    return node != nullptr ? node : new Node;
+  }
+
+  // Destroys the values of a private chain and recycles its nodes.
+  void Release(Node *first) noexcept {
+    if (first == nullptr) {
+      return;
+    }
+    Node *last = first;
+    for (;;) {
+      last->Value()->~T();
+      Node *next = last->next_.load(std::memory_order_relaxed);
+      if (next == nullptr) {
+        break;
+      }
+      last = next;
+    }
+    free_.PushChain(first, last);
+  }
+
+ private:
+  // The stack top and the node free list sit on separate cache lines.
+  alignas(CACHE_LINE) TaggedHead top_;
+  alignas(CACHE_LINE) TaggedHead free_;
+};
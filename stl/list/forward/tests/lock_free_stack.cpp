@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../lock_free_stack.hpp"
+
+TEST(LockFreeStackTests, PushPop) {
+  LockFreeStack<int> stack;
+  ASSERT_TRUE(stack.IsEmpty());
+  int value = -1;
+  ASSERT_FALSE(stack.Pop(value));
+  for (int i = 0; i < 100; ++i) {
+    stack.Push(i);
+  }
+  ASSERT_FALSE(stack.IsEmpty());
+  for (int i = 99; i >= 0; --i) {
+    ASSERT_TRUE(stack.Pop(value));
+    ASSERT_EQ(value, i);
+  }
+  ASSERT_FALSE(stack.Pop(value));
+  ASSERT_TRUE(stack.IsEmpty());
+}
+
+TEST(LockFreeStackTests, PushChainAndPopAll) {
+  LockFreeStack<std::string> stack;
+  stack.Push("bottom");
+  std::vector<std::string> batch{"a", "b", "c"};
+  stack.PushChain(batch.begin(), batch.end());
+  std::vector<std::string> popped;
+  size_t count =
+      stack.PopAll([&](std::string &&value) { popped.push_back(value); });
+  ASSERT_EQ(count, 4);
+  ASSERT_EQ(popped, (std::vector<std::string>{"c", "b", "a", "bottom"}));
+  ASSERT_TRUE(stack.IsEmpty());
+  ASSERT_EQ(stack.PopAll([](std::string &&) {}), 0);
+  stack.PushChain(batch.begin(), batch.begin());
+  ASSERT_TRUE(stack.IsEmpty());
+}
+
+TEST(LockFreeStackTests, MoveOnlyValues) {
+  LockFreeStack<std::unique_ptr<int>> stack;
+  stack.Push(std::make_unique<int>(1));
+  stack.Emplace(new int(2));
+  std::unique_ptr<int> value;
+  ASSERT_TRUE(stack.Pop(value));
+  ASSERT_EQ(*value, 2);
+  // The remaining value is released by the destructor.
+}
+
+TEST(LockFreeStackTests, ThrowingMoveAssignKeepsValue) {
+  struct Brittle {
+    explicit Brittle(int value) : value_(value) {}
+    Brittle(Brittle &&) noexcept = default;
+    Brittle &operator=(Brittle &&other) {
+      if (other.value_ < 0) {
+        throw std::runtime_error("negative");
+      }
+      value_ = other.value_;
+      return *this;
+    }
+    int value_;
+  };
+  LockFreeStack<Brittle> stack;
+  stack.Emplace(1);
+  stack.Emplace(-1);
+  Brittle out(0);
+  EXPECT_THROW({ stack.Pop(out); }, std::runtime_error);
+  EXPECT_THROW({ stack.Pop(out); }, std::runtime_error);
+  std::vector<int> values;
+  stack.PopAll([&](Brittle &&value) { values.push_back(value.value_); });
+  ASSERT_EQ(values, (std::vector<int>{-1, 1}));
+  stack.Emplace(2);
+  ASSERT_TRUE(stack.Pop(out));
+  ASSERT_EQ(out.value_, 2);
+}
+
+TEST(LockFreeStackTests, ConcurrentPushPop) {
+  const int threads = 4;
+  const int per_thread = 50000;
+  LockFreeStack<int> stack;
+  std::atomic<long long> popped_sum{0};
+  std::atomic<int> popped_count{0};
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      long long sum = 0;
+      int count = 0;
+      for (int i = 0; i < per_thread; ++i) {
+        stack.Push(t * per_thread + i);
+        int value;
+        // Popping right away keeps nodes cycling through the free list,
+        // which is where ABA would show up.
+        if (stack.Pop(value)) {
+          sum += value;
+          ++count;
+        }
+      }
+      popped_sum += sum;
+      popped_count += count;
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  long long rest = 0;
+  int rest_count = 0;
+  stack.PopAll([&](int &&value) {
+    rest += value;
+    ++rest_count;
+  });
+  long long total = threads * per_thread;
+  ASSERT_EQ(popped_count + rest_count, total);
+  ASSERT_EQ(popped_sum + rest, total * (total - 1) / 2);
+}
+
+TEST(LockFreeStackTests, ConcurrentChainsAndPopAll) {
+  const int producers = 3;
+  const int chains = 2000;
+  LockFreeStack<int> stack;
+  std::atomic<int> done{0};
+  std::vector<int> seen;
+  std::thread consumer([&] {
+    auto collect = [&](int &&value) { seen.push_back(value); };
+    while (done.load() < producers) {
+      stack.PopAll(collect);
+    }
+    stack.PopAll(collect);
+  });
+  std::vector<std::thread> workers;
+  for (int t = 0; t < producers; ++t) {
+    workers.emplace_back([&, t] {
+      for (int i = 0; i < chains; ++i) {
+        int base = (t * chains + i) * 4;
+        std::vector<int> batch{base, base + 1, base + 2, base + 3};
+        stack.PushChain(batch.begin(), batch.end());
+      }
+      ++done;
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  consumer.join();
+  std::sort(seen.begin(), seen.end());
+  ASSERT_EQ(seen.size(), static_cast<size_t>(producers * chains * 4));
+  for (size_t i = 0; i < seen.size(); ++i) {
+    ASSERT_EQ(seen[i], static_cast<int>(i));
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
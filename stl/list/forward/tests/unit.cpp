@@ -1,11 +1,36 @@
 #include <gtest/gtest.h>
 #include <forward_list>
 #include <future>
+#include <memory>
+#include <string>
+#include <vector>
 #include <thread>
 
 
 #include "../forward_list.hpp"
 
+// Counts copies; has no default constructor.
+struct Tracked {
+  static int copies;
+  int value;
+
+  explicit Tracked(int v) : value(v) {}
+  Tracked(int a, int b) : value(a + b) {}
+  Tracked(const Tracked &other) : value(other.value) { ++copies; }
+  Tracked(Tracked &&other) noexcept : value(other.value) {}
+  Tracked &operator=(const Tracked &other) {
+    value = other.value;
+    ++copies;
+    return *this;
+  }
+  Tracked &operator=(Tracked &&other) noexcept {
+    value = other.value;
+    return *this;
+  }
+};
+
+int Tracked::copies = 0;
+
 class ListTest : public testing::Test {
  protected:
   void SetUp() override {
@@ -163,12 +188,130 @@ TEST_F(ListTest, InsertMedium) {
   ASSERT_EQ(*it, 52);
 }
 
+TEST_F(ListTest, InsertAfterReturnsInserted) {
+  auto it = list.InsertAfter(list.BeforeBegin(), 8);
+  ASSERT_EQ(*it, 8);
+  ASSERT_EQ(list.Front(), 8);
+  it = list.InsertAfter(it, 9);
+  ASSERT_EQ(*it, 9);
+  ASSERT_EQ(*(++list.Begin()), 9);
+  ASSERT_EQ(list.Size(), sz + 2);
+}
+
+TEST_F(ListTest, EraseAfterKeepsTail) {
+  auto it = list.Begin();
+  for (size_t i = 0; i + 2 < sz; ++i) {
+    ++it;
+  }
+  auto next = list.EraseAfter(it);
+  ASSERT_TRUE(next == list.End());
+  ASSERT_EQ(list.Back(), 2);
+  list.PushBack(0);
+  ASSERT_EQ(list.Back(), 0);
+  EXPECT_THROW({ list.EraseAfter(++it); }, ListIsEmptyException);
+  while (!list.IsEmpty()) {
+    list.EraseAfter(list.BeforeBegin());
+  }
+  list.PushBack(5);
+  ASSERT_EQ(list.Front(), 5);
+  ASSERT_EQ(list.Back(), 5);
+}
+
+TEST(EmptyListTest, BuildWithIterators) {
+  ForwardList<int> list;
+  auto it = list.BeforeBegin();
+  for (int i = 0; i < 100000; ++i) {
+    it = list.InsertAfter(it, i);
+  }
+  ASSERT_EQ(list.Size(), 100000);
+  ASSERT_EQ(list.Back(), 99999);
+  int expected = 0;
+  for (auto jt = list.Begin(); jt != list.End(); ++jt) {
+    ASSERT_EQ(*jt, expected++);
+  }
+  ASSERT_EQ(*list.Find(500), 500);
+  ASSERT_TRUE(list.Find(-1) == list.End());
+}
+
+TEST(EmptyListTest, PushBackAndAppend) {
+  ForwardList<int> list;
+  ForwardList<int> other;
+  for (int i = 0; i < 5; ++i) {
+    list.PushBack(i);
+    other.PushBack(i + 5);
+  }
+  list.Append(other);
+  ASSERT_TRUE(other.IsEmpty());
+  ASSERT_TRUE(other.Begin() == other.End());
+  ASSERT_EQ(list.Size(), 10);
+  ASSERT_EQ(list.Back(), 9);
+  list.PushBack(10);
+  int expected = 0;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    ASSERT_EQ(*it, expected++);
+  }
+  ASSERT_EQ(expected, 11);
+  other.PushBack(42);
+  ASSERT_EQ(other.Front(), 42);
+  list.Append(list);
+  ASSERT_EQ(list.Size(), 11);
+}
+
+TEST(EmptyListTest, SwapKeepsTails) {
+  ForwardList<int> list{1, 2, 3};
+  ForwardList<int> empty;
+  list.Swap(empty);
+  ASSERT_TRUE(list.IsEmpty());
+  list.PushBack(4);
+  empty.PushBack(5);
+  ASSERT_EQ(list.Front(), 4);
+  ASSERT_EQ(empty.Back(), 5);
+  ASSERT_EQ(empty.Size(), 4);
+}
+
 TEST_F(ListTest, Clear) {
   list.Clear();
   ASSERT_TRUE(list.IsEmpty());
   ASSERT_EQ(list.Size(), 0);
 }
 
+TEST(ForwardListEmplaceTest, ConstructsInPlace) {
+  Tracked::copies = 0;
+  ForwardList<Tracked> list;
+  list.EmplaceBack(2);
+  list.EmplaceFront(1);
+  ASSERT_EQ(list.EmplaceBack(1, 2).value, 3);
+  list.PushBack(Tracked(4));
+  list.PushFront(Tracked(0));
+  auto it = list.EmplaceAfter(list.Begin(), 5);
+  ASSERT_EQ(it->value, 5);
+  list.InsertAfter(it, Tracked(6));
+  ASSERT_EQ(Tracked::copies, 0);
+  std::vector<int> values;
+  for (auto jt = list.Begin(); jt != list.End(); ++jt) {
+    values.push_back(jt->value);
+  }
+  ASSERT_EQ(values, (std::vector<int>{0, 5, 6, 1, 2, 3, 4}));
+}
+
+TEST(ForwardListEmplaceTest, MoveOnlyElements) {
+  ForwardList<std::unique_ptr<int>> list;
+  list.PushBack(std::make_unique<int>(1));
+  list.EmplaceFront(new int(0));
+  list.InsertAfter(list.BeforeBegin(), std::make_unique<int>(-1));
+  ForwardList<std::unique_ptr<int>> moved = std::move(list);
+  ASSERT_TRUE(list.IsEmpty());
+  ASSERT_EQ(moved.Size(), 3);
+  int expected = -1;
+  for (auto it = moved.Begin(); it != moved.End(); ++it) {
+    ASSERT_EQ(**it, expected++);
+  }
+  list = std::move(moved);
+  ASSERT_EQ(*list.Back(), 1);
+  list.PopFront();
+  ASSERT_EQ(*list.Front(), 0);
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
 
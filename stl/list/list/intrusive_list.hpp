@@ -0,0 +1,212 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#include "exceptions.hpp"
+
+// Links embedded in an object that can sit in an IntrusiveList. An object
+// gets one hook per list it may belong to at the same time. Copying an
+// object does not copy its membership.
+class ListHook {
+ public:
+  ListHook() = default;
+
+  ListHook(const ListHook &) {}
+
+  ListHook &operator=(const ListHook &) { return *this; }
+
+  inline bool IsLinked() const noexcept { return next_ != nullptr; }
+
+ private:
+  template <typename T, ListHook T::*Hook> friend class IntrusiveList;
+
+  ListHook *prev_ = nullptr;
+  ListHook *next_ = nullptr;
+};
+
+// Doubly linked list over objects it does not own: the links live in the
+// ListHook member Hook of T, so insertion never allocates and an object can
+// be unlinked in O(1) from a reference alone. The list is circular through
+// a sentinel hook, so there are no null checks on the hot paths. Objects
+// must outlive their membership; destroying the list just unlinks them.
+template <typename T, ListHook T::*Hook> class IntrusiveList {
+ public:
+  class ListIterator {
+   public:
+    // NOLINTNEXTLINE
+    using value_type = T;
+    // NOLINTNEXTLINE
+    using reference_type = value_type &;
+    // NOLINTNEXTLINE
+    using pointer_type = value_type *;
+    // NOLINTNEXTLINE
+    using difference_type = std::ptrdiff_t;
+    // NOLINTNEXTLINE
+    using iterator_category = std::bidirectional_iterator_tag;
+
+    inline bool operator==(const ListIterator &other) const {
+      return this->current_ == other.current_;
+    };
+    inline bool operator!=(const ListIterator &other) const {
+      return this->current_ != other.current_;
+    };
+
+    inline reference_type operator*() const { return *Owner(current_); };
+
+    inline pointer_type operator->() const { return Owner(current_); };
+
+    ListIterator &operator++() {
+      this->current_ = this->current_->next_;
+      return *this;
+    };
+
+    ListIterator operator++(int) {
+      ListIterator new_iter(this->current_);
+      this->current_ = this->current_->next_;
+      return new_iter;
+    };
+
+    ListIterator &operator--() {
+      this->current_ = this->current_->prev_;
+      return *this;
+    };
+
+    ListIterator operator--(int) {
+      ListIterator new_iter(this->current_);
+      this->current_ = this->current_->prev_;
+      return new_iter;
+    };
+
+   private:
+    friend class IntrusiveList;
+    explicit ListIterator(ListHook *hook) : current_(hook) {}
+
+   private:
+    ListHook *current_;
+  };
+
+ public:
+  IntrusiveList() : size_(0) {
+    sentinel_.prev_ = &sentinel_;
+    sentinel_.next_ = &sentinel_;
+  }
+
+  IntrusiveList(const IntrusiveList &) = delete;
+
+  IntrusiveList &operator=(const IntrusiveList &) = delete;
+
+  ~IntrusiveList() { Clear(); }
+
+  ListIterator Begin() noexcept { return ListIterator(sentinel_.next_); }
+
+  ListIterator End() noexcept { return ListIterator(&sentinel_); }
+
+  // Iterator to an object that is in this list.
+  ListIterator IteratorTo(T &value) noexcept {
+    return ListIterator(&(value.*Hook));
+  }
+
+  inline T &Front() const {
+    if (size_ == 0) {
+      throw ListIsEmptyException("List is empty");
+    }
+    return *Owner(sentinel_.next_);
+  }
+
+  inline T &Back() const {
+    if (size_ == 0) {
+      throw ListIsEmptyException("List is empty");
+    }
+    return *Owner(sentinel_.prev_);
+  }
+
+  inline bool IsEmpty() const noexcept { return (size_ == 0); }
+
+  inline size_t Size() const noexcept { return size_; }
+
+  // Links value before pos. value must not be in a list through Hook.
+  void Insert(ListIterator pos, T &value) noexcept {
+    ListHook *hook = &(value.*Hook);
+    ListHook *next = pos.current_;
+    hook->prev_ = next->prev_;
+    hook->next_ = next;
+    next->prev_->next_ = hook;
+    next->prev_ = hook;
+    ++size_;
+  }
+
+  void PushBack(T &value) noexcept { Insert(End(), value); }
+
+  void PushFront(T &value) noexcept { Insert(Begin(), value); }
+
+  // Unlinks value, which must be in this list.
+  void Erase(T &value) noexcept { Unlink(&(value.*Hook)); }
+
+  // Unlinks the object at pos and returns an iterator to the next one.
+  ListIterator Erase(ListIterator pos) noexcept {
+    ListHook *next = pos.current_->next_;
+    Unlink(pos.current_);
+    return ListIterator(next);
+  }
+
+  void PopBack() {
+    if (size_ == 0) {
+      throw ListIsEmptyException("List is empty");
+    }
+    Unlink(sentinel_.prev_);
+  }
+
+  void PopFront() {
+    if (size_ == 0) {
+      throw ListIsEmptyException("List is empty");
+    }
+    Unlink(sentinel_.next_);
+  }
+
+  void Clear() noexcept {
+    ListHook *iter = sentinel_.next_;
+    while (iter != &sentinel_) {
+      ListHook *next = iter->next_;
+      iter->prev_ = nullptr;
+      iter->next_ = nullptr;
+      iter = next;
+    }
+    sentinel_.prev_ = &sentinel_;
+    sentinel_.next_ = &sentinel_;
+    size_ = 0;
+  }
+
+ private:
+  void Unlink(ListHook *hook) noexcept {
+    hook->prev_->next_ = hook->next_;
+    hook->next_->prev_ = hook->prev_;
+    hook->prev_ = nullptr;
+    hook->next_ = nullptr;
+    --size_;
+  }
+
+  // Distance from the start of a T to its Hook. It is fixed for the type,
+  // so it is measured once, on storage aligned and sized for a T, and does
+  // not depend on what any list holds.
+  static std::ptrdiff_t HookOffset() noexcept {
+    static const std::ptrdiff_t offset = [] {
+      alignas(T) static unsigned char storage[sizeof(T)];
+      const T *probe = reinterpret_cast<const T *>(storage);
+      return reinterpret_cast<const char *>(&(probe->*Hook)) -
+             reinterpret_cast<const char *>(storage);
+    }();
+    return offset;
+  }
+
+  // Recovers the object from its hook.
+  static T *Owner(const ListHook *hook) noexcept {
+    return reinterpret_cast<T *>(reinterpret_cast<std::uintptr_t>(hook) -
+                                 HookOffset());
+  }
+
+ private:
+  ListHook sentinel_;
+  size_t size_;
+};
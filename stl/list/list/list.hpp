@@ -2,28 +2,62 @@
 
 #include <cstddef>
 #include <cstdlib>
+#include <atomic>
 #include <functional>
 #include <iterator>
+#include <new>
 #include <utility>
 
 #include "exceptions.hpp"
 
 template <typename T> class List {
  private:
-  class Node {
+  // The link part of a node. The list owns one bare NodeBase, end_, that
+  // closes the chain into a ring: End() points at it, and an empty list is
+  // end_ linked to itself. No T is ever built for the sentinel, so T does
+  // not have to be default constructible.
+  class NodeBase {
+    friend class ListIterator;
+    friend class List;
+
+  protected:
+    NodeBase *next_ = nullptr;
+    NodeBase *prev_ = nullptr;
+  };
+
+  struct Slab;
+
+  class Node : public NodeBase {
     friend class ListIterator;
     friend class List;
 
   private:
+    // The block Compact built this node in, or nullptr when the node has an
+    // allocation of its own.
+    Slab *slab_ = nullptr;
     T data_;
-    Node *next_ = nullptr;
-    Node *prev_ = nullptr;
 
   private:
-    Node() = default;
-    explicit Node(const T &data) : data_(data) {};
+    template <class... Args>
+    explicit Node(Args &&...args) : data_(std::forward<Args>(args)...) {}
+  };
+
+  static T &Data(NodeBase *node) { return static_cast<Node *>(node)->data_; }
+
+  // Header of one contiguous block of nodes made by Compact; the nodes
+  // follow it in the same allocation. They are destroyed in place instead of
+  // deleted, and the block is freed with the last of them, in whichever list
+  // it ended up, so Splice and Merge move compacted nodes like any other.
+  struct Slab {
+    std::atomic<size_t> live_{0};
   };
 
+  static constexpr size_t SLAB_ALIGN =
+      alignof(Node) > alignof(Slab) ? alignof(Node) : alignof(Slab);
+  // Offset of the first node in a block.
+  static constexpr size_t SLAB_HEADER =
+      (sizeof(Slab) + SLAB_ALIGN - 1) / SLAB_ALIGN * SLAB_ALIGN;
+
  public:
   class ListIterator {
    public:
@@ -45,7 +79,7 @@ template <typename T> class List {
       return this->current_ != other.current_;
     };
 
-    inline reference_type operator*() const { return this->current_->data_; };
+    inline reference_type operator*() const { return Data(this->current_); };
 
     ListIterator &operator++() {
       this->current_ = this->current_->next_;
@@ -71,7 +105,7 @@ template <typename T> class List {
 
     inline pointer_type operator->() const {
       if (current_ != nullptr) {
-        return &(current_->data_);
+        return &Data(current_);
       } else {
         return nullptr;
       }
@@ -79,31 +113,21 @@ template <typename T> class List {
 
    private:
     friend class List<T>;
-    explicit ListIterator(Node *node_ptr) : current_(node_ptr) {}
+    explicit ListIterator(NodeBase *node_ptr) : current_(node_ptr) {}
 
    private:
-    Node *current_;
+    NodeBase *current_;
   };
 
  public:
-  List() : head_(nullptr), tail_(nullptr), size_(0) {}
+  List() : size_(0) {
+    end_.next_ = &end_;
+    end_.prev_ = &end_;
+  }
 
   explicit List(size_t sz) : List() {
-    if (sz != 0) {
-      Node *begin_node = new Node();
-      Node *end_node = new Node();
-      head_ = begin_node;
-      tail_ = end_node;
-      head_->next_ = tail_;
-      tail_->prev_ = head_;
-      ++size_;
-      for (size_t i = 1; i < sz; ++i) {
-        Node *new_node = new Node();
-        tail_->next_ = new_node;
-        new_node->prev_ = tail_;
-        tail_ = new_node;
-        ++size_;
-      }
+    for (size_t i = 0; i < sz; ++i) {
+      EmplaceBack();
     }
   }
 
@@ -114,48 +138,76 @@ template <typename T> class List {
   }
 
   List(const List &other) : List() {
-    Node *iter = other.head_;
-    while (iter != other.tail_) {
-      this->PushBack(iter->data_);
-      iter = iter->next_;
+    for (NodeBase *iter = other.end_.next_; iter != &other.end_;
+         iter = iter->next_) {
+      PushBack(Data(iter));
     }
   }
 
+  // Takes over other's nodes; other is left empty.
+  List(List &&other) noexcept : List() { Swap(other); }
+
   List &operator=(const List &other) {
     if (this == &other) {
       return *this;
     }
     this->Clear();
-    Node *iter = other.head_;
-    while (iter != other.tail_) {
-      PushBack(iter->data_);
-      iter = iter->next_;
+    for (NodeBase *iter = other.end_.next_; iter != &other.end_;
+         iter = iter->next_) {
+      PushBack(Data(iter));
     }
     return *this;
   }
 
-  ListIterator Begin() const noexcept { return ListIterator(head_); }
+  List &operator=(List &&other) noexcept {
+    if (this != &other) {
+      Clear();
+      Swap(other);
+    }
+    return *this;
+  }
+
+  ListIterator Begin() const noexcept { return ListIterator(end_.next_); }
 
-  ListIterator End() const noexcept { return ListIterator(tail_); }
+  ListIterator End() const noexcept {
+    return ListIterator(const_cast<NodeBase *>(&end_));
+  }
 
-  inline T &Front() const { return head_->data_; }
+  inline T &Front() const {
+    if (size_ == 0) {
+      throw ListIsEmptyException("List is empty");
+    }
+    return Data(end_.next_);
+  }
 
-  inline T &Back() const { return tail_->prev_->data_; }
+  inline T &Back() const {
+    if (size_ == 0) {
+      throw ListIsEmptyException("List is empty");
+    }
+    return Data(end_.prev_);
+  }
 
   inline bool IsEmpty() const noexcept { return (size_ == 0); }
 
   inline size_t Size() const noexcept { return size_; }
 
-  void Swap(List &other) {
-    std::swap(this->head_, other.head_);
-    std::swap(this->tail_, other.tail_);
-    std::swap(this->size_, other.size_);
+  // The sentinels stay in place: the lists exchange the ends of their rings,
+  // then point the rings at their new sentinel.
+  void Swap(List &other) noexcept {
+    if (this == &other) {
+      return;
+    }
+    std::swap(end_.next_, other.end_.next_);
+    std::swap(end_.prev_, other.end_.prev_);
+    std::swap(size_, other.size_);
+    CloseRing();
+    other.CloseRing();
   }
 
   ListIterator Find(const T &value) const {
-    Node *iter = head_;
-    while (iter != tail_) {
-      if (iter->data_ == value) {
+    NodeBase *iter = end_.next_;
+    while (iter != &end_) {
+      if (Data(iter) == value) {
         break;
       }
       iter = iter->next_;
@@ -164,114 +216,323 @@ template <typename T> class List {
   }
 
   void Erase(ListIterator pos) {
-    if (head_ == nullptr) {
+    if (size_ == 0) {
       throw ListIsEmptyException("List is empty");
-    } else if (pos.current_ != head_) {
-      pos.current_->prev_->next_ = pos.current_->next_;
-      pos.current_->next_->prev_ = pos.current_->prev_;
-      delete pos.current_;
-    } else {
-      head_ = head_->next_;
-      delete head_->prev_;
-      head_->prev_ = nullptr;
     }
+    NodeBase *node = pos.current_;
+    node->prev_->next_ = node->next_;
+    node->next_->prev_ = node->prev_;
+    FreeNode(node);
     --size_;
   }
 
-  void Insert(ListIterator pos, const T &value) {
-    Node *new_node = new Node(value);
-    new_node->next_ = pos.current_;
-    new_node->prev_ = pos.current_->prev_;
-    if (new_node->prev_) {
-      new_node->prev_->next_ = new_node;
-    } else {
-      head_ = new_node;
+  ListIterator Insert(ListIterator pos, const T &value) {
+    return Emplace(pos, value);
+  }
+
+  ListIterator Insert(ListIterator pos, T &&value) {
+    return Emplace(pos, std::move(value));
+  }
+
+  // Builds the element in its node before pos and returns an iterator to it.
+  template <class... Args>
+  ListIterator Emplace(ListIterator pos, Args &&...args) {
+    NodeBase *new_node = new Node(std::forward<Args>(args)...);
+    Link(pos.current_, new_node);
+    return ListIterator(new_node);
+  }
+
+  // Moves all nodes of other before pos. No element is copied or moved.
+  void Splice(ListIterator pos, List &other) noexcept {
+    if (&other == this || other.size_ == 0) {
+      return;
     }
-    if (new_node->next_) {
-      new_node->next_->prev_ = new_node;
-    } else {
-      tail_ = new_node;
+    Transfer(pos.current_, other.end_.next_, &other.end_);
+    size_ += other.size_;
+    other.size_ = 0;
+  }
+
+  // Moves the node at it, which belongs to other, before pos.
+  void Splice(ListIterator pos, List &other, ListIterator it) noexcept {
+    NodeBase *next = it.current_->next_;
+    if (pos.current_ == it.current_ || pos.current_ == next) {
+      return;
+    }
+    Transfer(pos.current_, it.current_, next);
+    if (&other != this) {
+      ++size_;
+      --other.size_;
     }
-    ++size_;
   }
 
-  void Clear() noexcept {
-    while (head_ != tail_) {
-      head_ = head_->next_;
-      delete head_->prev_;
+  // Moves the nodes [first, last) of other before pos, which must not lie
+  // inside the range. Counting the range is linear when the lists differ.
+  void Splice(ListIterator pos, List &other, ListIterator first,
+              ListIterator last) noexcept {
+    if (first == last) {
+      return;
+    }
+    if (&other != this) {
+      size_t count = 0;
+      for (NodeBase *iter = first.current_; iter != last.current_;
+           iter = iter->next_) {
+        ++count;
+      }
+      size_ += count;
+      other.size_ -= count;
+    }
+    Transfer(pos.current_, first.current_, last.current_);
+  }
+
+  // Merges the sorted list other into this sorted list in linear time.
+  // Equal elements keep their order, the ones from this list first.
+  template <class Compare = std::less<T>>
+  void Merge(List &other, Compare comp = Compare()) {
+    if (&other == this || other.size_ == 0) {
+      return;
     }
-    if (tail_ != nullptr) {
-      delete tail_;
+    NodeBase *iter = end_.next_;
+    NodeBase *from = other.end_.next_;
+    while (from != &other.end_) {
+      if (iter == &end_) {
+        Transfer(&end_, from, &other.end_);
+        break;
+      }
+      if (comp(Data(from), Data(iter))) {
+        NodeBase *next = from->next_;
+        Transfer(iter, from, next);
+        from = next;
+      } else {
+        iter = iter->next_;
+      }
+    }
+    size_ += other.size_;
+    other.size_ = 0;
+  }
+
+  // Stable bottom-up merge sort. Nodes are relinked, elements never move,
+  // and the only extra memory is a fixed array of partial runs.
+  template <class Compare = std::less<T>> void Sort(Compare comp = Compare()) {
+    if (size_ < 2) {
+      return;
     }
-    head_ = nullptr;
-    tail_ = nullptr;
+    NodeBase *chain = end_.next_;
+    end_.prev_->next_ = nullptr;
+    // runs[i] is a sorted chain of 2^i nodes, or nullptr.
+    NodeBase *runs[64] = {};
+    while (chain != nullptr) {
+      NodeBase *run = chain;
+      chain = chain->next_;
+      run->next_ = nullptr;
+      size_t level = 0;
+      for (; runs[level] != nullptr; ++level) {
+        run = MergeChains(runs[level], run, comp);
+        runs[level] = nullptr;
+      }
+      runs[level] = run;
+    }
+    NodeBase *sorted = nullptr;
+    for (NodeBase *run : runs) {
+      if (run != nullptr) {
+        sorted = sorted == nullptr ? run : MergeChains(run, sorted, comp);
+      }
+    }
+    NodeBase *prev = &end_;
+    for (NodeBase *iter = sorted; iter != nullptr; iter = iter->next_) {
+      iter->prev_ = prev;
+      prev->next_ = iter;
+      prev = iter;
+    }
+    prev->next_ = &end_;
+    end_.prev_ = prev;
+  }
+
+  void Clear() noexcept {
+    NodeBase *iter = end_.next_;
+    while (iter != &end_) {
+      NodeBase *next = iter->next_;
+      FreeNode(iter);
+      iter = next;
+    }
+    end_.next_ = &end_;
+    end_.prev_ = &end_;
     size_ = 0;
   }
 
-  void PushBack(const T &value) {
-    if (head_ == nullptr) {
-      head_ = new Node(value);
-      tail_ = new Node();
-      head_->next_ = tail_;
-      tail_->prev_ = head_;
-      ++size_;
-    } else {
-      Node *new_node = new Node();
-      tail_->data_ = value;
-      tail_->next_ = new_node;
-      new_node->prev_ = tail_;
-      tail_ = new_node;
-      ++size_;
+  // Moves all elements into one freshly allocated block of nodes laid out
+  // in iteration order, so that walking the list reads memory sequentially
+  // again after long runs of Insert/Erase. Every element is move-constructed
+  // exactly once; the list stays linked and valid after each step, so if a
+  // move throws, the elements before it are compacted and the rest are
+  // untouched. Invalidates all iterators.
+  void Compact() {
+    if (size_ == 0) {
+      return;
+    }
+    void *block = ::operator new(SLAB_HEADER + size_ * sizeof(Node),
+                                 std::align_val_t(SLAB_ALIGN));
+    Slab *slab = ::new (block) Slab;
+    Node *slot = reinterpret_cast<Node *>(static_cast<char *>(block) +
+                                          SLAB_HEADER);
+    size_t placed = 0;
+    try {
+      NodeBase *iter = end_.next_;
+      while (iter != &end_) {
+        Node *fresh = ::new (static_cast<void *>(slot))
+            Node(std::move(Data(iter)));
+        fresh->slab_ = slab;
+        ++slot;
+        ++placed;
+        NodeBase *next = iter->next_;
+        fresh->prev_ = iter->prev_;
+        fresh->next_ = next;
+        iter->prev_->next_ = fresh;
+        next->prev_ = fresh;
+        FreeNode(iter);
+        iter = next;
+      }
+    } catch (...) {
+      SealSlab(slab, placed);
+      throw;
     }
+    SealSlab(slab, placed);
   }
 
-  void PushFront(const T &value) {
-    Node *new_node = new Node(value);
-    new_node->next_ = head_;
-    head_->prev_ = new_node;
-    head_ = new_node;
-    ++size_;
+  // Calls fn on every element in order. Prefetches the node after next
+  // while fn runs, which hides part of the miss latency when the nodes are
+  // scattered. fn must not erase elements.
+  template <class F> void ForEach(F fn) {
+    NodeBase *iter = end_.next_;
+    while (iter != &end_) {
+      NodeBase *next = iter->next_;
+#if defined(__GNUC__)
+      __builtin_prefetch(next->next_);
+#endif
+      fn(Data(iter));
+      iter = next;
+    }
+  }
+
+  void PushBack(const T &value) { EmplaceBack(value); }
+
+  void PushBack(T &&value) { EmplaceBack(std::move(value)); }
+
+  void PushFront(const T &value) { EmplaceFront(value); }
+
+  void PushFront(T &&value) { EmplaceFront(std::move(value)); }
+
+  template <class... Args> T &EmplaceBack(Args &&...args) {
+    return *Emplace(End(), std::forward<Args>(args)...);
+  }
+
+  template <class... Args> T &EmplaceFront(Args &&...args) {
+    return *Emplace(Begin(), std::forward<Args>(args)...);
   }
 
   void PopBack() {
-    if (head_ == nullptr) {
+    if (size_ == 0) {
       throw ListIsEmptyException("List is empty");
     }
-    if (size_ == 1) {
-      delete head_;
-      delete tail_;
-      head_ = nullptr;
-      tail_ = nullptr;
-    } else {
-      tail_->prev_ = tail_->prev_->prev_;
-      delete tail_->prev_->next_;
-      tail_->prev_->next_ = tail_;
-    }
-    --size_;
+    Erase(ListIterator(end_.prev_));
   }
 
   void PopFront() {
-    if (head_ == nullptr) {
+    if (size_ == 0) {
       throw ListIsEmptyException("List is empty");
     }
-    if (size_ == 1) {
-      delete head_;
-      delete tail_;
-      head_ = nullptr;
-      tail_ = nullptr;
-    } else {
-      head_ = head_->next_;
-      delete head_->prev_;
-      head_->prev_ = nullptr;
-    }
-    --size_;
+    Erase(ListIterator(end_.next_));
   }
 
   ~List() { Clear(); }
 
  private:
-  Node *head_;
-  Node *tail_;
+  void Link(NodeBase *pos, NodeBase *node) noexcept {
+    node->next_ = pos;
+    node->prev_ = pos->prev_;
+    pos->prev_->next_ = node;
+    pos->prev_ = node;
+    ++size_;
+  }
+
+  // Links the first and last node back to end_, or end_ to itself when the
+  // list is empty.
+  void CloseRing() noexcept {
+    if (size_ == 0) {
+      end_.next_ = &end_;
+      end_.prev_ = &end_;
+    } else {
+      end_.next_->prev_ = &end_;
+      end_.prev_->next_ = &end_;
+    }
+  }
+
+  static void FreeNode(NodeBase *node) noexcept {
+    Node *owned = static_cast<Node *>(node);
+    Slab *slab = owned->slab_;
+    if (slab == nullptr) {
+      delete owned;
+      return;
+    }
+    owned->~Node();
+    if (slab->live_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      FreeSlab(slab);
+    }
+  }
+
+  // Gives a block built by Compact the count of nodes placed in it, or frees
+  // it right away if none were.
+  static void SealSlab(Slab *slab, size_t placed) noexcept {
+    if (placed == 0) {
+      FreeSlab(slab);
+    } else {
+      slab->live_.store(placed, std::memory_order_release);
+    }
+  }
+
+  static void FreeSlab(Slab *slab) noexcept {
+    slab->~Slab();
+    ::operator delete(static_cast<void *>(slab), std::align_val_t(SLAB_ALIGN));
+  }
+
+  // Unlinks [first, last) from its ring and links it before pos. Sizes are
+  // left to the caller.
+  static void Transfer(NodeBase *pos, NodeBase *first, NodeBase *last) {
+    if (pos == first || pos == last) {
+      return;
+    }
+    NodeBase *before_first = first->prev_;
+    NodeBase *last_moved = last->prev_;
+    NodeBase *before_pos = pos->prev_;
+    before_first->next_ = last;
+    last->prev_ = before_first;
+    before_pos->next_ = first;
+    first->prev_ = before_pos;
+    last_moved->next_ = pos;
+    pos->prev_ = last_moved;
+  }
+
+  // Merges two null-terminated sorted chains linked through next_ only,
+  // preferring first on ties.
+  template <class Compare>
+  static NodeBase *MergeChains(NodeBase *first, NodeBase *second,
+                               Compare &comp) {
+    NodeBase *head = nullptr;
+    NodeBase **link = &head;
+    while (first != nullptr && second != nullptr) {
+      if (comp(Data(second), Data(first))) {
+        *link = second;
+        second = second->next_;
+      } else {
+        *link = first;
+        first = first->next_;
+      }
+      link = &(*link)->next_;
+    }
+    *link = first != nullptr ? first : second;
+    return head;
+  }
+
+  NodeBase end_;
   size_t size_;
 };
 
@@ -282,4 +543,4 @@ template <typename T>
 void swap(List<T> &a, List<T> &b) {
   a.Swap(b);
 }
-} // namespace std
\ No newline at end of file
+} // namespace std
@@ -0,0 +1,194 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../intrusive_list.hpp"
+
+struct Connection {
+  explicit Connection(int id) : id(id) {}
+
+  int id;
+  std::string payload;
+  ListHook lru_hook;
+  ListHook active_hook;
+};
+
+using LruList = IntrusiveList<Connection, &Connection::lru_hook>;
+using ActiveList = IntrusiveList<Connection, &Connection::active_hook>;
+
+TEST(IntrusiveListTest, DefaultConstructor) {
+  LruList list;
+  ASSERT_TRUE(list.IsEmpty());
+  ASSERT_TRUE(list.Begin() == list.End());
+  EXPECT_THROW({ list.PopBack(); }, ListIsEmptyException);
+  EXPECT_THROW({ list.Front(); }, ListIsEmptyException);
+}
+
+TEST(IntrusiveListTest, PushAndIterate) {
+  std::vector<Connection> conns;
+  for (int i = 0; i < 5; ++i) {
+    conns.emplace_back(i);
+  }
+  LruList list;
+  list.PushBack(conns[2]);
+  list.PushBack(conns[3]);
+  list.PushFront(conns[1]);
+  list.PushFront(conns[0]);
+  list.Insert(list.End(), conns[4]);
+  ASSERT_EQ(list.Size(), 5);
+  int expected = 0;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    ASSERT_EQ(it->id, expected);
+    ASSERT_EQ(&*it, &conns[expected]);
+    ++expected;
+  }
+  auto it = list.End();
+  for (int i = 4; i >= 0; --i) {
+    --it;
+    ASSERT_EQ((*it).id, i);
+  }
+  ASSERT_EQ(list.Front().id, 0);
+  ASSERT_EQ(list.Back().id, 4);
+}
+
+TEST(IntrusiveListTest, EraseByReference) {
+  std::vector<Connection> conns;
+  for (int i = 0; i < 6; ++i) {
+    conns.emplace_back(i);
+  }
+  LruList list;
+  for (auto &conn : conns) {
+    list.PushBack(conn);
+  }
+  list.Erase(conns[3]);
+  list.Erase(conns[0]);
+  list.Erase(conns[5]);
+  ASSERT_FALSE(conns[3].lru_hook.IsLinked());
+  ASSERT_TRUE(conns[4].lru_hook.IsLinked());
+  ASSERT_EQ(list.Size(), 3);
+  std::vector<int> ids;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    ids.push_back(it->id);
+  }
+  ASSERT_EQ(ids, (std::vector<int>{1, 2, 4}));
+  auto next = list.Erase(list.IteratorTo(conns[2]));
+  ASSERT_EQ(next->id, 4);
+  list.PushFront(conns[3]);
+  ASSERT_EQ(list.Front().id, 3);
+}
+
+TEST(IntrusiveListTest, SeveralListsAtOnce) {
+  std::vector<Connection> conns;
+  for (int i = 0; i < 10; ++i) {
+    conns.emplace_back(i);
+  }
+  LruList lru;
+  ActiveList active;
+  for (auto &conn : conns) {
+    lru.PushBack(conn);
+    if (conn.id % 2 == 0) {
+      active.PushFront(conn);
+    }
+  }
+  lru.Erase(conns[4]);
+  ASSERT_TRUE(conns[4].active_hook.IsLinked());
+  ASSERT_EQ(lru.Size(), 9);
+  ASSERT_EQ(active.Size(), 5);
+  ASSERT_EQ(active.Front().id, 8);
+  active.PopFront();
+  ASSERT_EQ(active.Front().id, 6);
+  lru.PopBack();
+  ASSERT_EQ(lru.Back().id, 8);
+  ASSERT_TRUE(conns[8].lru_hook.IsLinked());
+  ASSERT_FALSE(conns[8].active_hook.IsLinked());
+}
+
+TEST(IntrusiveListTest, ClearUnlinksEverything) {
+  std::vector<Connection> conns;
+  for (int i = 0; i < 3; ++i) {
+    conns.emplace_back(i);
+  }
+  {
+    LruList list;
+    for (auto &conn : conns) {
+      list.PushBack(conn);
+    }
+  }
+  for (auto &conn : conns) {
+    ASSERT_FALSE(conn.lru_hook.IsLinked());
+  }
+  LruList list;
+  list.PushBack(conns[0]);
+  Connection copy = conns[0];
+  ASSERT_FALSE(copy.lru_hook.IsLinked());
+  list.Clear();
+  ASSERT_TRUE(list.IsEmpty());
+  ASSERT_FALSE(conns[0].lru_hook.IsLinked());
+}
+
+// Not standard-layout: the hook sits behind a vtable pointer and a base.
+struct Named {
+  virtual ~Named() = default;
+  std::string name;
+};
+
+struct Timer : Named {
+  explicit Timer(int deadline) : deadline(deadline) {}
+  int deadline;
+  ListHook hook;
+};
+
+TEST(IntrusiveListTest, PolymorphicOwner) {
+  std::vector<Timer> timers;
+  for (int i = 0; i < 4; ++i) {
+    timers.emplace_back(i * 10);
+  }
+  IntrusiveList<Timer, &Timer::hook> list;
+  for (auto &timer : timers) {
+    list.PushFront(timer);
+  }
+  ASSERT_EQ(&list.Front(), &timers[3]);
+  ASSERT_EQ(&list.Back(), &timers[0]);
+  int expected = 30;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    ASSERT_EQ(it->deadline, expected);
+    expected -= 10;
+  }
+  auto it = list.IteratorTo(timers[2]);
+  ASSERT_EQ((*it).deadline, 20);
+  it = list.Erase(it);
+  ASSERT_EQ(it->deadline, 10);
+}
+
+// The hook a list uses is not the first member.
+struct Obj {
+  int a;
+  int b;
+  ListHook first;
+  ListHook second;
+  int value;
+};
+
+TEST(IntrusiveListTest, IteratorTakenBeforeFirstInsert) {
+  IntrusiveList<Obj, &Obj::second> list;
+  auto end = list.End();
+  auto begin = list.Begin();
+  Obj x{1, 2, {}, {}, 42};
+  Obj y{3, 4, {}, {}, 43};
+  list.PushBack(x);
+  --end;
+  ASSERT_EQ(end->value, 42);
+  ASSERT_EQ(&*end, &x);
+  list.PushBack(y);
+  ++end;
+  ASSERT_EQ((*end).value, 43);
+  ASSERT_EQ(begin, list.End());
+  ++begin;
+  ASSERT_EQ(&*begin, &x);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
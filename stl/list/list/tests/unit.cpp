@@ -1,11 +1,41 @@
+#include <algorithm>
+#include <functional>
 #include <future>
 #include <list>
+#include <memory>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include <thread>
 
 #include <gtest/gtest.h>
 
 #include "../list.hpp"
 
+// Counts copies; has no default constructor.
+struct Tracked {
+  static int copies;
+  int value;
+
+  explicit Tracked(int v) : value(v) {}
+  Tracked(int a, int b) : value(a + b) {}
+  Tracked(const Tracked &other) : value(other.value) { ++copies; }
+  Tracked(Tracked &&other) noexcept : value(other.value) {}
+  Tracked &operator=(const Tracked &other) {
+    value = other.value;
+    ++copies;
+    return *this;
+  }
+  Tracked &operator=(Tracked &&other) noexcept {
+    value = other.value;
+    return *this;
+  }
+};
+
+int Tracked::copies = 0;
+
 class ListTest : public testing::Test {
  protected:
   void SetUp() override {
@@ -230,6 +260,389 @@ TEST_F(ListTest, Clear) {
   ASSERT_EQ(list.Size(), 0);
 }
 
+template <typename T> std::vector<T> ToVector(const List<T> &list) {
+  std::vector<T> values;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    values.push_back(*it);
+  }
+  return values;
+}
+
+TEST_F(ListTest, SpliceWholeList) {
+  List<int> other{10, 11, 12};
+  auto pos = list.Begin();
+  ++pos;
+  list.Splice(pos, other);
+  ASSERT_EQ(list.Size(), sz + 3);
+  ASSERT_TRUE(other.IsEmpty());
+  ASSERT_EQ(ToVector(list), (std::vector<int>{1, 10, 11, 12, 2, 3, 4, 5, 6, 7}));
+  other.PushBack(20);
+  ASSERT_EQ(other.Front(), 20);
+  List<int> empty;
+  empty.Splice(empty.End(), list);
+  ASSERT_EQ(empty.Size(), sz + 3);
+  ASSERT_EQ(empty.Back(), 7);
+  ASSERT_TRUE(list.IsEmpty());
+  EXPECT_THROW({ list.PopBack(); }, ListIsEmptyException);
+}
+
+TEST_F(ListTest, SpliceSingleNode) {
+  List<int> other{10, 11};
+  int *address = &*other.Begin();
+  list.Splice(list.Begin(), other, other.Begin());
+  ASSERT_EQ(&list.Front(), address);
+  ASSERT_EQ(other.Size(), 1);
+  ASSERT_EQ(list.Size(), sz + 1);
+  auto last = list.End();
+  --last;
+  list.Splice(list.Begin(), list, last);
+  ASSERT_EQ(ToVector(list), (std::vector<int>{7, 10, 1, 2, 3, 4, 5, 6}));
+  list.Splice(list.Begin(), list, list.Begin());
+  ASSERT_EQ(list.Front(), 7);
+}
+
+TEST_F(ListTest, SpliceRange) {
+  List<int> other{10, 11, 12, 13};
+  auto first = other.Begin();
+  ++first;
+  auto last = first;
+  ++last;
+  ++last;
+  list.Splice(list.End(), other, first, last);
+  ASSERT_EQ(ToVector(list), (std::vector<int>{1, 2, 3, 4, 5, 6, 7, 11, 12}));
+  ASSERT_EQ(ToVector(other), (std::vector<int>{10, 13}));
+  ASSERT_EQ(list.Size(), sz + 2);
+  ASSERT_EQ(other.Size(), 2);
+  auto from = list.Begin();
+  auto to = from;
+  for (int i = 0; i < 3; ++i) {
+    ++to;
+  }
+  list.Splice(list.End(), list, from, to);
+  ASSERT_EQ(ToVector(list), (std::vector<int>{4, 5, 6, 7, 11, 12, 1, 2, 3}));
+  ASSERT_EQ(list.Size(), sz + 2);
+}
+
+TEST(EmptyListTest, Merge) {
+  List<int> first{1, 3, 5, 7, 9};
+  List<int> second{0, 2, 3, 10, 11};
+  first.Merge(second);
+  ASSERT_EQ(ToVector(first),
+            (std::vector<int>{0, 1, 2, 3, 3, 5, 7, 9, 10, 11}));
+  ASSERT_EQ(first.Size(), 10);
+  ASSERT_TRUE(second.IsEmpty());
+  List<int> empty;
+  empty.Merge(first, std::less<int>());
+  ASSERT_EQ(empty.Size(), 10);
+  ASSERT_EQ(empty.Front(), 0);
+  ASSERT_EQ(empty.Back(), 11);
+}
+
+TEST(EmptyListTest, MergeIsStable) {
+  using Item = std::pair<int, int>;
+  auto by_key = [](const Item &a, const Item &b) { return a.first < b.first; };
+  List<Item> first{{1, 0}, {2, 0}, {2, 1}};
+  List<Item> second{{2, 2}, {3, 0}};
+  first.Merge(second, by_key);
+  ASSERT_EQ(ToVector(first),
+            (std::vector<Item>{{1, 0}, {2, 0}, {2, 1}, {2, 2}, {3, 0}}));
+}
+
+TEST(EmptyListTest, Sort) {
+  List<int> list;
+  std::list<int> model;
+  std::mt19937 gen(9);
+  std::uniform_int_distribution<int> value_dist(0, 999);
+  for (int i = 0; i < 10007; ++i) {
+    int value = value_dist(gen);
+    list.PushBack(value);
+    model.push_back(value);
+  }
+  std::vector<int *> addresses;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    addresses.push_back(&*it);
+  }
+  list.Sort();
+  model.sort();
+  ASSERT_EQ(ToVector(list), std::vector<int>(model.begin(), model.end()));
+  ASSERT_EQ(list.Size(), 10007);
+  std::vector<int *> sorted_addresses;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    sorted_addresses.push_back(&*it);
+  }
+  std::sort(addresses.begin(), addresses.end());
+  std::sort(sorted_addresses.begin(), sorted_addresses.end());
+  ASSERT_EQ(addresses, sorted_addresses);
+  auto it = list.End();
+  for (auto rit = model.rbegin(); rit != model.rend(); ++rit) {
+    --it;
+    ASSERT_EQ(*it, *rit);
+  }
+  list.Sort(std::greater<int>());
+  ASSERT_EQ(list.Front(), 999);
+  list.PushFront(-1);
+  ASSERT_EQ(list.Front(), -1);
+}
+
+TEST(EmptyListTest, SortIsStable) {
+  using Item = std::pair<int, int>;
+  List<Item> list;
+  for (int i = 0; i < 100; ++i) {
+    list.PushBack({i % 5, i});
+  }
+  list.Sort([](const Item &a, const Item &b) { return a.first < b.first; });
+  Item prev{-1, -1};
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    ASSERT_TRUE(prev.first < it->first ||
+                (prev.first == it->first && prev.second < it->second));
+    prev = *it;
+  }
+}
+
+TEST(ListEmplaceTest, ConstructsInPlace) {
+  Tracked::copies = 0;
+  List<Tracked> list;
+  list.EmplaceBack(2);
+  list.EmplaceFront(1);
+  ASSERT_EQ(list.EmplaceBack(1, 2).value, 3);
+  list.PushBack(Tracked(4));
+  auto it = list.Emplace(++list.Begin(), 5);
+  ASSERT_EQ(it->value, 5);
+  list.Insert(list.End(), Tracked(6));
+  ASSERT_EQ(Tracked::copies, 0);
+  std::vector<int> values;
+  for (auto jt = list.Begin(); jt != list.End(); ++jt) {
+    values.push_back(jt->value);
+  }
+  ASSERT_EQ(values, (std::vector<int>{1, 5, 2, 3, 4, 6}));
+  list.Sort(
+      [](const Tracked &a, const Tracked &b) { return a.value < b.value; });
+  ASSERT_EQ(list.Front().value, 1);
+  ASSERT_EQ(list.Back().value, 6);
+  ASSERT_EQ(Tracked::copies, 0);
+}
+
+TEST(ListEmplaceTest, MoveOnlyElements) {
+  List<std::unique_ptr<int>> list;
+  list.PushBack(std::make_unique<int>(1));
+  list.EmplaceFront(new int(0));
+  list.Insert(list.End(), std::make_unique<int>(2));
+  List<std::unique_ptr<int>> moved = std::move(list);
+  ASSERT_TRUE(list.IsEmpty());
+  ASSERT_EQ(moved.Size(), 3);
+  int expected = 0;
+  for (auto it = moved.Begin(); it != moved.End(); ++it) {
+    ASSERT_EQ(**it, expected++);
+  }
+  list = std::move(moved);
+  ASSERT_EQ(*list.Back(), 2);
+  list.PopBack();
+  list.PopFront();
+  ASSERT_EQ(*list.Front(), 1);
+}
+
+TEST(ListEmplaceTest, EmptyFrontBackThrow) {
+  List<int> list;
+  EXPECT_THROW({ list.Front(); }, ListIsEmptyException);
+  EXPECT_THROW({ list.Back(); }, ListIsEmptyException);
+  List<int> other{1, 2};
+  list.Swap(other);
+  ASSERT_EQ(list.Back(), 2);
+  ASSERT_TRUE(other.IsEmpty());
+  other.PushBack(3);
+  ASSERT_EQ(other.Front(), 3);
+}
+
+TEST(ListCompactTest, CompactKeepsOrderAndPacksNodes) {
+  List<int> list;
+  std::mt19937 gen(42);
+  for (int i = 0; i < 2000; ++i) {
+    auto pos = list.Begin();
+    for (size_t step = gen() % (list.Size() + 1); step > 0; --step) {
+      ++pos;
+    }
+    list.Insert(pos, i);
+  }
+  for (auto it = list.Begin(); it != list.End();) {
+    auto next = it;
+    ++next;
+    if (*it % 3 == 0) {
+      list.Erase(it);
+    }
+    it = next;
+  }
+  std::vector<int> before = ToVector(list);
+  list.Compact();
+  ASSERT_EQ(ToVector(list), before);
+  ASSERT_EQ(list.Size(), before.size());
+  // Consecutive elements sit at a fixed stride in one block.
+  auto it = list.Begin();
+  const char *prev = reinterpret_cast<const char *>(&*it);
+  ++it;
+  std::ptrdiff_t stride = reinterpret_cast<const char *>(&*it) - prev;
+  ASSERT_GT(stride, 0);
+  for (; it != list.End(); ++it) {
+    const char *cur = reinterpret_cast<const char *>(&*it);
+    ASSERT_EQ(cur - prev, stride);
+    prev = cur;
+  }
+}
+
+TEST(ListCompactTest, ModifyAfterCompact) {
+  List<std::string> list;
+  for (int i = 0; i < 100; ++i) {
+    list.PushBack(std::to_string(i));
+  }
+  list.Compact();
+  list.PopFront();
+  list.PopBack();
+  list.PushFront("front");
+  list.Insert(++list.Begin(), "second");
+  list.Compact();
+  list.Compact();
+  ASSERT_EQ(list.Size(), 100);
+  ASSERT_EQ(list.Front(), "front");
+  ASSERT_EQ(*(++list.Begin()), "second");
+  ASSERT_EQ(list.Back(), "98");
+  list.Sort();
+  list.Clear();
+  ASSERT_TRUE(list.IsEmpty());
+  list.Compact();
+  list.PushBack("again");
+  ASSERT_EQ(list.Front(), "again");
+}
+
+TEST(ListCompactTest, CompactedNodesOutliveTheirList) {
+  List<std::unique_ptr<int>> other;
+  {
+    List<std::unique_ptr<int>> list;
+    for (int i = 0; i < 10; ++i) {
+      list.PushBack(std::make_unique<int>(i));
+    }
+    list.Compact();
+    auto first = list.Begin();
+    auto last = first;
+    for (int i = 0; i < 4; ++i) {
+      ++last;
+    }
+    other.Splice(other.End(), list, first, last);
+    other.Splice(other.End(), list, --list.End());
+    List<std::unique_ptr<int>> moved = std::move(list);
+    ASSERT_EQ(moved.Size(), 5);
+  }
+  ASSERT_EQ(other.Size(), 5);
+  std::vector<int> values;
+  other.ForEach([&](const std::unique_ptr<int> &value) {
+    values.push_back(*value);
+  });
+  ASSERT_EQ(values, (std::vector<int>{0, 1, 2, 3, 9}));
+  other.PopFront();
+  other.Compact();
+  ASSERT_EQ(*other.Front(), 1);
+}
+
+TEST(ListCompactTest, MoveAndSwapCompactedLists) {
+  static_assert(std::is_nothrow_move_constructible<List<int>>::value);
+  static_assert(std::is_nothrow_move_assignable<List<int>>::value);
+  List<std::string> first;
+  List<std::string> second;
+  for (int i = 0; i < 50; ++i) {
+    first.PushBack("a" + std::to_string(i));
+    second.PushBack("b" + std::to_string(i));
+  }
+  first.Compact();
+  second.Compact();
+  first.Swap(second);
+  ASSERT_EQ(first.Front(), "b0");
+  ASSERT_EQ(second.Back(), "a49");
+  List<std::string> moved(std::move(first));
+  ASSERT_TRUE(first.IsEmpty());
+  first = std::move(second);
+  ASSERT_TRUE(second.IsEmpty());
+  second.Swap(moved);
+  ASSERT_TRUE(moved.IsEmpty());
+  ASSERT_EQ(first.Size(), 50);
+  ASSERT_EQ(second.Size(), 50);
+  ASSERT_EQ(first.Front(), "a0");
+  ASSERT_EQ(second.Back(), "b49");
+  // The blocks went with their nodes, so erasing still destroys in place.
+  while (!first.IsEmpty()) {
+    first.PopFront();
+  }
+  second.Erase(++second.Begin());
+  second.Compact();
+  ASSERT_EQ(*(++second.Begin()), "b2");
+  moved.Swap(moved);
+  ASSERT_TRUE(moved.IsEmpty());
+}
+
+TEST(ListCompactTest, SpliceAndEraseAcrossCompactedLists) {
+  static_assert(noexcept(std::declval<List<int> &>().Splice(
+      std::declval<List<int> &>().End(), std::declval<List<int> &>())));
+  List<std::string> lists[3];
+  for (int l = 0; l < 3; ++l) {
+    for (int i = 0; i < 20; ++i) {
+      lists[l].PushBack(std::to_string(l * 100 + i));
+    }
+    lists[l].Compact();
+  }
+  // Deal single nodes of each list into the next one, so every list ends up
+  // holding nodes from all three blocks plus ones of its own.
+  for (int round = 0; round < 10; ++round) {
+    for (int l = 0; l < 3; ++l) {
+      List<std::string> &to = lists[(l + 1) % 3];
+      to.Splice(to.Begin(), lists[l], lists[l].Begin());
+    }
+    lists[round % 3].PushBack("own" + std::to_string(round));
+  }
+  lists[0].Splice(lists[0].End(), lists[1], ++lists[1].Begin(),
+                  lists[1].End());
+  lists[2].Merge(lists[1]);
+  size_t total = 0;
+  for (auto &list : lists) {
+    total += list.Size();
+  }
+  ASSERT_EQ(total, 70);
+  ASSERT_TRUE(lists[1].IsEmpty());
+  // Erase every other node, then drop what is left in different ways.
+  for (auto &list : lists) {
+    for (auto it = list.Begin(); it != list.End();) {
+      auto next = it;
+      ++next;
+      list.Erase(it);
+      if (next != list.End()) {
+        ++next;
+      }
+      it = next;
+    }
+  }
+  std::vector<std::string> before = ToVector(lists[0]);
+  ASSERT_FALSE(before.empty());
+  lists[0].Compact();
+  ASSERT_EQ(ToVector(lists[0]), before);
+  while (!lists[2].IsEmpty()) {
+    lists[2].PopBack();
+  }
+  lists[1].Splice(lists[1].End(), lists[0]);
+  lists[1].Clear();
+  for (auto &list : lists) {
+    ASSERT_TRUE(list.IsEmpty());
+  }
+}
+
+TEST(ListCompactTest, ForEach) {
+  List<int> list{1, 2, 3, 4, 5};
+  int sum = 0;
+  list.ForEach([&](int &value) {
+    sum += value;
+    value *= 2;
+  });
+  ASSERT_EQ(sum, 15);
+  ASSERT_EQ(ToVector(list), (std::vector<int>{2, 4, 6, 8, 10}));
+  List<int> empty;
+  empty.ForEach([&](int &) { FAIL(); });
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
 
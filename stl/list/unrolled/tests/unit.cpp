@@ -0,0 +1,185 @@
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../unrolled_list.hpp"
+
+template <typename T, size_t Bytes>
+std::vector<T> ToVector(const UnrolledList<T, Bytes> &list) {
+  std::vector<T> values;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    values.push_back(*it);
+  }
+  return values;
+}
+
+TEST(UnrolledListTests, DefaultConstructor) {
+  UnrolledList<int> list;
+  ASSERT_EQ(list.Size(), 0);
+  ASSERT_TRUE(list.IsEmpty());
+  ASSERT_TRUE(list.Begin() == list.End());
+  EXPECT_THROW({ list.Front(); }, ListIsEmptyException);
+  EXPECT_THROW({ list.Back(); }, ListIsEmptyException);
+  EXPECT_THROW({ list.PopBack(); }, ListIsEmptyException);
+  EXPECT_THROW({ list.PopFront(); }, ListIsEmptyException);
+}
+
+TEST(UnrolledListTests, NodeCapacity) {
+  ASSERT_GE((UnrolledList<int, 256>::NODE_CAPACITY), 50);
+  ASSERT_EQ((UnrolledList<int, 16>::NODE_CAPACITY), 2);
+}
+
+TEST(UnrolledListTests, PushBackAndFront) {
+  UnrolledList<int, 64> list;
+  for (int i = 0; i < 100; ++i) {
+    list.PushBack(i);
+    list.PushFront(-i - 1);
+  }
+  ASSERT_EQ(list.Size(), 200);
+  ASSERT_EQ(list.Front(), -100);
+  ASSERT_EQ(list.Back(), 99);
+  int expected = -100;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    ASSERT_EQ(*it, expected++);
+  }
+}
+
+TEST(UnrolledListTests, ReverseIteration) {
+  UnrolledList<int, 64> list;
+  for (int i = 0; i < 100; ++i) {
+    list.PushBack(i);
+  }
+  int expected = 99;
+  auto it = list.End();
+  for (size_t i = 0; i < list.Size(); ++i) {
+    --it;
+    ASSERT_EQ(*it, expected--);
+  }
+  ASSERT_TRUE(it == list.Begin());
+}
+
+TEST(UnrolledListTests, InsertSplitsFullNode) {
+  UnrolledList<int, 64> list;
+  size_t cap = UnrolledList<int, 64>::NODE_CAPACITY;
+  for (size_t i = 0; i < cap; ++i) {
+    list.PushBack(static_cast<int>(i));
+  }
+  auto pos = list.Begin();
+  for (size_t i = 0; i < cap / 2 + 1; ++i) {
+    ++pos;
+  }
+  auto it = list.Insert(pos, -1);
+  ASSERT_EQ(*it, -1);
+  ++it;
+  ASSERT_EQ(*it, static_cast<int>(cap / 2 + 1));
+  std::vector<int> expected;
+  for (size_t i = 0; i < cap; ++i) {
+    if (i == cap / 2 + 1) {
+      expected.push_back(-1);
+    }
+    expected.push_back(static_cast<int>(i));
+  }
+  ASSERT_EQ(ToVector(list), expected);
+}
+
+TEST(UnrolledListTests, EraseReturnsNext) {
+  UnrolledList<int, 32> list{1, 2, 3, 4, 5, 6, 7};
+  auto it = list.Begin();
+  ++it;
+  it = list.Erase(it);
+  ASSERT_EQ(*it, 3);
+  it = list.Erase(it);
+  ASSERT_EQ(*it, 4);
+  ++it;
+  ++it;
+  ++it;
+  it = list.Erase(it);
+  ASSERT_TRUE(it == list.End());
+  ASSERT_EQ(ToVector(list), (std::vector<int>{1, 4, 5, 6}));
+}
+
+TEST(UnrolledListTests, PopUntilEmpty) {
+  UnrolledList<int, 64> list;
+  for (int i = 0; i < 1000; ++i) {
+    list.PushBack(i);
+  }
+  for (int i = 0; i < 500; ++i) {
+    ASSERT_EQ(list.Front(), i);
+    list.PopFront();
+    ASSERT_EQ(list.Back(), 999 - i);
+    list.PopBack();
+  }
+  ASSERT_TRUE(list.IsEmpty());
+  ASSERT_TRUE(list.Begin() == list.End());
+  list.PushFront(7);
+  ASSERT_EQ(list.Front(), 7);
+  ASSERT_EQ(list.Back(), 7);
+}
+
+TEST(UnrolledListTests, InsertAliasedValue) {
+  UnrolledList<std::string, 128> list{"a", "b", "c"};
+  list.Insert(list.Begin(), list.Back());
+  ASSERT_EQ(ToVector(list), (std::vector<std::string>{"c", "a", "b", "c"}));
+}
+
+TEST(UnrolledListTests, CopyAndAssign) {
+  UnrolledList<std::string, 64> list;
+  for (int i = 0; i < 50; ++i) {
+    list.PushBack(std::to_string(i));
+  }
+  UnrolledList<std::string, 64> copy = list;
+  ASSERT_EQ(ToVector(copy), ToVector(list));
+  UnrolledList<std::string, 64> other{"x"};
+  other = list;
+  ASSERT_EQ(ToVector(other), ToVector(list));
+  other.Clear();
+  ASSERT_TRUE(other.IsEmpty());
+  ASSERT_EQ(list.Size(), 50);
+}
+
+template <size_t Bytes> void RandomAgainstModel(unsigned seed) {
+  UnrolledList<std::string, Bytes> list;
+  std::list<std::string> model;
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> op_dist(0, 4);
+  for (int step = 0; step < 20000; ++step) {
+    size_t pos = gen() % (model.size() + 1);
+    auto it = list.Begin();
+    auto model_it = model.begin();
+    for (size_t i = 0; i < pos; ++i) {
+      ++it;
+      ++model_it;
+    }
+    if (model.size() < 50 || (op_dist(gen) < 2 && pos < model.size())) {
+      std::string value = std::to_string(step);
+      auto inserted = list.Insert(it, value);
+      model.insert(model_it, value);
+      ASSERT_EQ(*inserted, value);
+    } else if (pos < model.size()) {
+      auto next = list.Erase(it);
+      model_it = model.erase(model_it);
+      if (model_it == model.end()) {
+        ASSERT_TRUE(next == list.End());
+      } else {
+        ASSERT_EQ(*next, *model_it);
+      }
+    }
+    ASSERT_EQ(list.Size(), model.size());
+  }
+  ASSERT_EQ(ToVector(list),
+            std::vector<std::string>(model.begin(), model.end()));
+}
+
+TEST(UnrolledListTests, RandomInsertErase) {
+  RandomAgainstModel<64>(42);
+  RandomAgainstModel<256>(7);
+  RandomAgainstModel<1024>(1);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
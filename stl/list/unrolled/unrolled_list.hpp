@@ -0,0 +1,356 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <utility>
+
+#include "../list/exceptions.hpp"
+
+// Doubly linked list of small arrays. Every node holds up to NODE_CAPACITY
+// elements in place, so a walk touches one node header per run of elements
+// and the per-element link overhead is amortized over the whole array.
+//
+// Inserting into a full node splits it in half; erasing from a node that
+// falls below a quarter full pulls in its successor when both fit into one
+// node. Both only shift elements inside at most two nodes, so the cost does
+// not depend on the length of the list. The list is circular through a
+// sentinel link that carries no elements.
+template <typename T, size_t BytesPerNode = 256> class UnrolledList {
+  struct Link {
+    Link *prev_;
+    Link *next_;
+  };
+
+ public:
+  // Whatever fits next to the header, but never fewer than two elements so
+  // that a split leaves something on both sides.
+  static constexpr size_t NODE_CAPACITY =
+      BytesPerNode >= sizeof(Link) + sizeof(size_t) + 2 * sizeof(T)
+          ? (BytesPerNode - sizeof(Link) - sizeof(size_t)) / sizeof(T)
+          : 2;
+
+ private:
+  struct Node : Link {
+    size_t count_;
+    alignas(T) unsigned char data_[sizeof(T) * NODE_CAPACITY];
+
+    T *Slot(size_t ind) {
+      return std::launder(reinterpret_cast<T *>(data_)) + ind;
+    }
+  };
+
+  static Node *AsNode(Link *link) { return static_cast<Node *>(link); }
+
+ public:
+  class ListIterator {
+   public:
+    // NOLINTNEXTLINE
+    using value_type = T;
+    // NOLINTNEXTLINE
+    using reference_type = value_type &;
+    // NOLINTNEXTLINE
+    using pointer_type = value_type *;
+    // NOLINTNEXTLINE
+    using difference_type = std::ptrdiff_t;
+    // NOLINTNEXTLINE
+    using iterator_category = std::bidirectional_iterator_tag;
+
+    inline bool operator==(const ListIterator &other) const {
+      return this->link_ == other.link_ && this->ind_ == other.ind_;
+    };
+    inline bool operator!=(const ListIterator &other) const {
+      return this->link_ != other.link_ || this->ind_ != other.ind_;
+    };
+
+    inline reference_type operator*() const {
+      return *AsNode(link_)->Slot(ind_);
+    };
+
+    inline pointer_type operator->() const {
+      return AsNode(link_)->Slot(ind_);
+    };
+
+    ListIterator &operator++() {
+      if (++ind_ == AsNode(link_)->count_) {
+        link_ = link_->next_;
+        ind_ = 0;
+      }
+      return *this;
+    };
+
+    ListIterator operator++(int) {
+      ListIterator new_iter(link_, ind_);
+      ++(*this);
+      return new_iter;
+    };
+
+    ListIterator &operator--() {
+      if (ind_ == 0) {
+        link_ = link_->prev_;
+        ind_ = AsNode(link_)->count_;
+      }
+      --ind_;
+      return *this;
+    };
+
+    ListIterator operator--(int) {
+      ListIterator new_iter(link_, ind_);
+      --(*this);
+      return new_iter;
+    };
+
+   private:
+    friend class UnrolledList;
+    ListIterator(Link *link, size_t ind) : link_(link), ind_(ind) {}
+
+   private:
+    Link *link_;
+    size_t ind_;
+  };
+
+ public:
+  UnrolledList() : size_(0) {
+    sentinel_.prev_ = &sentinel_;
+    sentinel_.next_ = &sentinel_;
+  }
+
+  UnrolledList(const std::initializer_list<T> &values) : UnrolledList() {
+    for (const auto &value : values) {
+      PushBack(value);
+    }
+  }
+
+  UnrolledList(const UnrolledList &other) : UnrolledList() {
+    for (auto it = other.Begin(); it != other.End(); ++it) {
+      PushBack(*it);
+    }
+  }
+
+  UnrolledList &operator=(const UnrolledList &other) {
+    if (this == &other) {
+      return *this;
+    }
+    Clear();
+    for (auto it = other.Begin(); it != other.End(); ++it) {
+      PushBack(*it);
+    }
+    return *this;
+  }
+
+  ~UnrolledList() { Clear(); }
+
+  ListIterator Begin() const noexcept {
+    return ListIterator(sentinel_.next_, 0);
+  }
+
+  ListIterator End() const noexcept {
+    return ListIterator(const_cast<Link *>(&sentinel_), 0);
+  }
+
+  inline T &Front() const {
+    if (size_ == 0) {
+      throw ListIsEmptyException("List is empty");
+    }
+    return *AsNode(sentinel_.next_)->Slot(0);
+  }
+
+  inline T &Back() const {
+    if (size_ == 0) {
+      throw ListIsEmptyException("List is empty");
+    }
+    Node *last = AsNode(sentinel_.prev_);
+    return *last->Slot(last->count_ - 1);
+  }
+
+  inline bool IsEmpty() const noexcept { return (size_ == 0); }
+
+  inline size_t Size() const noexcept { return size_; }
+
+  // Inserts value before pos and returns an iterator to it. Iterators into
+  // the affected node (and, on a split, its new neighbour) are invalidated.
+  ListIterator Insert(ListIterator pos, const T &value) {
+    return Emplace(pos, value);
+  }
+
+  ListIterator Insert(ListIterator pos, T &&value) {
+    return Emplace(pos, std::move(value));
+  }
+
+  template <class... Args>
+  ListIterator Emplace(ListIterator pos, Args &&...args) {
+    Node *node;
+    size_t ind;
+    if (pos.link_ == &sentinel_) {
+      // Appending: fill the last node before starting a new one.
+      Link *last = sentinel_.prev_;
+      if (last != &sentinel_ && AsNode(last)->count_ < NODE_CAPACITY) {
+        node = AsNode(last);
+      } else {
+        node = NewNode(last);
+      }
+      ind = node->count_;
+    } else {
+      node = AsNode(pos.link_);
+      ind = pos.ind_;
+      if (ind == 0 && node->count_ == NODE_CAPACITY &&
+          node->prev_ != &sentinel_ &&
+          AsNode(node->prev_)->count_ < NODE_CAPACITY) {
+        // Inserting at the front of a full node: the previous one has room.
+        node = AsNode(node->prev_);
+        ind = node->count_;
+      } else if (node->count_ == NODE_CAPACITY) {
+        // Built first: the arguments may refer to elements that the split
+        // moves away.
+        T value(std::forward<Args>(args)...);
+        Node *upper = Split(node);
+        if (ind > node->count_) {
+          ind -= node->count_;
+          node = upper;
+        }
+        InsertInto(node, ind, std::move(value));
+        ++size_;
+        return ListIterator(node, ind);
+      }
+    }
+    InsertInto(node, ind, std::forward<Args>(args)...);
+    ++size_;
+    return ListIterator(node, ind);
+  }
+
+  // Erases the element at pos and returns an iterator to the one after it.
+  ListIterator Erase(ListIterator pos) {
+    if (size_ == 0) {
+      throw ListIsEmptyException("List is empty");
+    }
+    Node *node = AsNode(pos.link_);
+    size_t ind = pos.ind_;
+    T *arr = node->Slot(0);
+    for (size_t i = ind + 1; i < node->count_; ++i) {
+      arr[i - 1] = std::move(arr[i]);
+    }
+    arr[node->count_ - 1].~T();
+    --node->count_;
+    --size_;
+    if (node->count_ == 0) {
+      Link *next = node->next_;
+      FreeNode(node);
+      return ListIterator(next, 0);
+    }
+    if (node->count_ < NODE_CAPACITY / 4 && node->next_ != &sentinel_ &&
+        node->count_ + AsNode(node->next_)->count_ <= NODE_CAPACITY) {
+      MergeNext(node);
+    }
+    if (ind < node->count_) {
+      return ListIterator(node, ind);
+    }
+    return ListIterator(node->next_, 0);
+  }
+
+  void PushBack(const T &value) { Emplace(End(), value); }
+
+  void PushBack(T &&value) { Emplace(End(), std::move(value)); }
+
+  void PushFront(const T &value) { Emplace(Begin(), value); }
+
+  void PushFront(T &&value) { Emplace(Begin(), std::move(value)); }
+
+  void PopBack() {
+    if (size_ == 0) {
+      throw ListIsEmptyException("List is empty");
+    }
+    Erase(--End());
+  }
+
+  void PopFront() {
+    if (size_ == 0) {
+      throw ListIsEmptyException("List is empty");
+    }
+    Erase(Begin());
+  }
+
+  void Clear() noexcept {
+    Link *iter = sentinel_.next_;
+    while (iter != &sentinel_) {
+      Node *node = AsNode(iter);
+      iter = iter->next_;
+      for (size_t i = 0; i < node->count_; ++i) {
+        node->Slot(i)->~T();
+      }
+      delete node;
+    }
+    sentinel_.prev_ = &sentinel_;
+    sentinel_.next_ = &sentinel_;
+    size_ = 0;
+  }
+
+ private:
+  // Links a new empty node after prev.
+  Node *NewNode(Link *prev) {
+    Node *node = new Node;
+    node->count_ = 0;
+    node->prev_ = prev;
+    node->next_ = prev->next_;
+    prev->next_->prev_ = node;
+    prev->next_ = node;
+    return node;
+  }
+
+  void FreeNode(Node *node) noexcept {
+    node->prev_->next_ = node->next_;
+    node->next_->prev_ = node->prev_;
+    delete node;
+  }
+
+  // Moves the upper half of a full node into a new node right after it.
+  Node *Split(Node *node) {
+    Node *upper = NewNode(node);
+    size_t keep = NODE_CAPACITY / 2;
+    T *from = node->Slot(0);
+    T *to = upper->Slot(0);
+    for (size_t i = keep; i < node->count_; ++i) {
+      ::new (static_cast<void *>(to + (i - keep))) T(std::move(from[i]));
+      from[i].~T();
+    }
+    upper->count_ = node->count_ - keep;
+    node->count_ = keep;
+    return upper;
+  }
+
+  void MergeNext(Node *node) {
+    Node *next = AsNode(node->next_);
+    T *from = next->Slot(0);
+    T *to = node->Slot(node->count_);
+    for (size_t i = 0; i < next->count_; ++i) {
+      ::new (static_cast<void *>(to + i)) T(std::move(from[i]));
+      from[i].~T();
+    }
+    node->count_ += next->count_;
+    next->count_ = 0;
+    FreeNode(next);
+  }
+
+  // Opens a gap at ind in a node that has room and builds the element there.
+  template <class... Args>
+  void InsertInto(Node *node, size_t ind, Args &&...args) {
+    T *arr = node->Slot(0);
+    size_t count = node->count_;
+    if (ind == count) {
+      ::new (static_cast<void *>(arr + count)) T(std::forward<Args>(args)...);
+    } else {
+      // Built first: the arguments may refer to elements that shift.
+      T value(std::forward<Args>(args)...);
+      ::new (static_cast<void *>(arr + count)) T(std::move(arr[count - 1]));
+      for (size_t i = count - 1; i > ind; --i) {
+        arr[i] = std::move(arr[i - 1]);
+      }
+      arr[ind] = std::move(value);
+    }
+    ++node->count_;
+  }
+
+ private:
+  Link sentinel_;
+  size_t size_;
+};
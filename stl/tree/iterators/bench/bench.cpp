@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "../map.hpp"
+
+// Times Insert, Find and Erase of n keys arriving in sorted, reverse and
+// random order. With a balanced tree the cost per operation grows with
+// log n, so each fourfold step in n should add a similar number of ns.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Keeps the lookups from being optimized away.
+volatile long long sink = 0;
+
+double NsPerOp(Clock::time_point start, size_t ops) {
+  auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      Clock::now() - start);
+  return static_cast<double>(elapsed.count()) / static_cast<double>(ops);
+}
+
+void Run(const std::string &order, const std::vector<int> &keys) {
+  Map<int, int> map;
+
+  auto start = Clock::now();
+  for (int key : keys) {
+    map.Insert({key, key});
+  }
+  double insert = NsPerOp(start, keys.size());
+
+  start = Clock::now();
+  for (int key : keys) {
+    sink = sink + map.Find(key)->second;
+  }
+  double find = NsPerOp(start, keys.size());
+
+  start = Clock::now();
+  for (int key : keys) {
+    map.Erase(key);
+  }
+  double erase = NsPerOp(start, keys.size());
+
+  fmt::print("{:<8} {:>9} {:>10.1f} {:>10.1f} {:>10.1f}\n", order,
+             keys.size(), insert, find, erase);
+}
+
+} // namespace
+
+int main() {
+  std::mt19937 gen(42);
+  fmt::print("{:<8} {:>9} {:>10} {:>10} {:>10}\n", "order", "n", "insert",
+             "find", "erase");
+  for (size_t n = 1 << 14; n <= (1 << 20); n <<= 2) {
+    std::vector<int> keys(n);
+    std::iota(keys.begin(), keys.end(), 0);
+    Run("sorted", keys);
+    std::reverse(keys.begin(), keys.end());
+    Run("reverse", keys);
+    std::shuffle(keys.begin(), keys.end(), gen);
+    Run("random", keys);
+  }
+  return 0;
+}
@@ -13,6 +13,7 @@
 template <typename Key, typename Value, typename Compare = std::less<Key>>
 class Map {
   class Node;
+  friend struct MapInspector;
 
 public:
   class MapIterator {
@@ -53,7 +54,7 @@ public:
 
     MapIterator operator++(int) {
       MapIterator tmp(this->current_);
-      current_ = current_->right_;
+      ++(*this);
       return tmp;
     };
 
@@ -88,32 +89,7 @@ public:
   }
 
   Value &operator[](const Key &key) {
-    Node *parent = FindParent(key);
-    if (parent->right_ == parent) {
-      if (parent->left_) {
-        return parent->left_->data_.second;
-      } else {
-        parent->left_ = new Node(std::make_pair(key, Value()));
-        ++size_;
-        return parent->left_->data_.second;
-      }
-    } else if (comp_(key, parent->data_.first)) {
-      if (parent->left_) {
-        return parent->left_->data_.second;
-      } else {
-        parent->left_ = new Node(std::make_pair(key, Value()));
-        ++size_;
-        return parent->left_->data_.second;
-      }
-    } else {
-      if (parent->right_) {
-        return parent->right_->data_.second;
-      } else {
-        parent->right_ = new Node(std::make_pair(key, Value()));
-        ++size_;
-        return parent->right_->data_.second;
-      }
-    }
+    return InsertNode(key).first->data_.second;
   }
 
   inline bool IsEmpty() const noexcept { return size_ == 0; }
@@ -141,38 +117,9 @@ public:
   }
 
   void Insert(const std::pair<const Key, Value> &val) {
-    Node *parent = FindParent(val.first);
-    if (parent->right_ == parent) {
-      if (parent->left_) {
-        parent->left_->data_.second = val.second;
-      } else {
-        Node *new_node = new Node(val);
-        parent->left_ = new_node;
-        new_node->is_right_thread_ = true;
-        new_node->right_ = parent;
-        ++size_;
-      }
-    } else if (comp_(val.first, parent->data_.first)) {
-      if (parent->left_) {
-        parent->left_->data_.second = val.second;
-      } else {
-        Node *new_node = new Node(val);
-        new_node->right_ = parent;
-        new_node->is_right_thread_ = true;
-        parent->left_ = new_node;
-        ++size_;
-      }
-    } else {
-      if (!parent->is_right_thread_) {
-        parent->right_->data_.second = val.second;
-      } else {
-        Node *new_node = new Node(val);
-        new_node->right_ = parent->right_;
-        new_node->is_right_thread_ = true;
-        parent->right_ = new_node;
-        parent->is_right_thread_ = false;
-        ++size_;
-      }
+    auto [node, inserted] = InsertNode(val.first, val.second);
+    if (!inserted) {
+      node->data_.second = val.second;
     }
   }
 
@@ -184,22 +131,11 @@ public:
   }
 
   void Erase(const Key &key) {
-    Node *parent = FindParent(key);
-    if (parent == root_) {
-      DeleteNode(parent, parent->left_, false);
-    } else if (comp_(key, parent->data_.first)) {
-      if (parent->left_) {
-        DeleteNode(parent, parent->left_, false);
-      } else {
-        throw KeyIsMissingInMap("Value not found");
-      }
-    } else {
-      if (!parent->is_right_thread_) {
-        DeleteNode(parent, parent->right_, true);
-      } else {
-        throw KeyIsMissingInMap("Value not found");
-      }
+    Node *node = FindNode(key);
+    if (node == nullptr) {
+      throw KeyIsMissingInMap("Value not found");
     }
+    EraseNode(node);
     --size_;
   }
 
@@ -210,28 +146,8 @@ public:
   }
 
   MapIterator Find(const Key &key) const {
-    Node *parent = FindParent(key);
-    if (parent->right_ == parent) {
-      if (parent->left_ == nullptr) {
-        return MapIterator(root_);
-      } else if (parent->left_->data_.first == key) {
-        return MapIterator(parent->left_);
-      } else {
-        throw KeyIsMissingInMap("Value not found");
-      }
-    } else if (comp_(key, parent->data_.first)) {
-      if (parent->left_) {
-        return MapIterator(parent->left_);
-      } else {
-        return MapIterator(root_);
-      }
-    } else {
-      if (!parent->is_right_thread_) {
-        return MapIterator(parent->right_);
-      } else {
-        return MapIterator(root_);
-      }
-    }
+    Node *node = FindNode(key);
+    return MapIterator(node == nullptr ? root_ : node);
   }
 
   ~Map() {
@@ -248,14 +164,17 @@ private:
     std::pair<const Key, Value> data_;
     Node *right_;
     Node *left_;
+    Node *parent_;
     bool is_right_thread_;
+    bool is_red_;
 
     Node()
-        : data_(), right_(nullptr), left_(nullptr), is_right_thread_(false) {}
+        : data_(), right_(nullptr), left_(nullptr), parent_(nullptr),
+          is_right_thread_(false), is_red_(false) {}
 
     explicit Node(std::pair<const Key, Value> data)
-        : data_(data), right_(nullptr), left_(nullptr),
-          is_right_thread_(false) {}
+        : data_(data), right_(nullptr), left_(nullptr), parent_(nullptr),
+          is_right_thread_(false), is_red_(true) {}
   };
 
 private:
@@ -264,91 +183,323 @@ private:
   size_t size_;
 
 private:
-  Node *FindParent(const Key &key) const {
-    Node *parent = root_;
-    Node *current = parent->left_;
-    Node *iter = nullptr;
+  // The tree is red-black balanced, so every path from root_->left_ down is
+  // O(log n) long even when keys arrive sorted. Each node knows its parent;
+  // the tree root's parent is the header root_, which lets rotations and
+  // unlinking treat the top like any other node (the root is always
+  // root_->left_, and root_->right_ is a thread to itself). A right_ that
+  // is a thread points to the in-order successor; the rotations and Erase
+  // below keep every thread pointing there.
+
+  static Node *RightChild(Node *node) {
+    return node->is_right_thread_ ? nullptr : node->right_;
+  }
+
+  static bool IsRed(Node *node) { return node != nullptr && node->is_red_; }
+
+  static Node *Leftmost(Node *node) {
+    while (node->left_) {
+      node = node->left_;
+    }
+    return node;
+  }
+
+  static Node *Rightmost(Node *node) {
+    while (!node->is_right_thread_) {
+      node = node->right_;
+    }
+    return node;
+  }
+
+  Node *FindNode(const Key &key) const {
+    Node *current = root_->left_;
     while (current) {
-      iter = current;
       if (comp_(key, current->data_.first)) {
         current = current->left_;
       } else if (comp_(current->data_.first, key)) {
-        if (!current->is_right_thread_) {
-          current = current->right_;
-        } else {
-          return current;
-        }
+        current = RightChild(current);
       } else {
-        return parent;
+        return current;
       }
-      parent = iter;
     }
-    return parent;
+    return nullptr;
   }
 
-  void DeleteNode(Node *parent, Node *current, bool is_right) {
-    if (current->left_ == nullptr && current->is_right_thread_) {
-      if (is_right) {
-        parent->right_ = current->right_;
-        parent->is_right_thread_ = true;
-        delete current;
+  // Returns the node for key and whether it had to be created.
+  template <class... V>
+  std::pair<Node *, bool> InsertNode(const Key &key, V &&...value) {
+    Node *parent = root_;
+    Node *current = root_->left_;
+    bool is_left = true;
+    while (current) {
+      parent = current;
+      if (comp_(key, current->data_.first)) {
+        current = current->left_;
+        is_left = true;
+      } else if (comp_(current->data_.first, key)) {
+        current = RightChild(current);
+        is_left = false;
       } else {
-        delete current;
-        parent->left_ = nullptr;
+        return {current, false};
       }
-    } else if (current->left_ && !current->is_right_thread_) {
-      if (current->left_->is_right_thread_) {
-        current->left_->is_right_thread_ = false;
-        current->left_->right_ = current->right_;
-        if (is_right) {
-          parent->right_ = current->left_;
-        } else {
-          parent->left_ = current->left_;
+    }
+    Node *new_node = new Node(
+        std::pair<const Key, Value>(key, Value(std::forward<V>(value)...)));
+    new_node->parent_ = parent;
+    new_node->is_right_thread_ = true;
+    if (is_left) {
+      new_node->right_ = parent;
+      parent->left_ = new_node;
+    } else {
+      new_node->right_ = parent->right_;
+      parent->right_ = new_node;
+      parent->is_right_thread_ = false;
+    }
+    ++size_;
+    InsertFixup(new_node);
+    return {new_node, true};
+  }
+
+  void ReplaceChild(Node *parent, Node *old_child, Node *new_child) {
+    if (parent->left_ == old_child) {
+      parent->left_ = new_child;
+    } else {
+      parent->right_ = new_child;
+    }
+  }
+
+  // node's right child takes its place.
+  void RotateLeft(Node *node) {
+    Node *child = node->right_;
+    if (child->left_) {
+      node->right_ = child->left_;
+      child->left_->parent_ = node;
+    } else {
+      // Nothing lies between node and child any more.
+      node->right_ = child;
+      node->is_right_thread_ = true;
+    }
+    child->parent_ = node->parent_;
+    ReplaceChild(node->parent_, node, child);
+    child->left_ = node;
+    node->parent_ = child;
+  }
+
+  // node's left child takes its place.
+  void RotateRight(Node *node) {
+    Node *child = node->left_;
+    if (child->is_right_thread_) {
+      node->left_ = nullptr;
+      child->is_right_thread_ = false;
+    } else {
+      node->left_ = child->right_;
+      child->right_->parent_ = node;
+    }
+    child->parent_ = node->parent_;
+    ReplaceChild(node->parent_, node, child);
+    child->right_ = node;
+    node->parent_ = child;
+  }
+
+  void InsertFixup(Node *node) {
+    while (IsRed(node->parent_)) {
+      Node *parent = node->parent_;
+      Node *grand = parent->parent_;
+      if (parent == grand->left_) {
+        Node *uncle = RightChild(grand);
+        if (IsRed(uncle)) {
+          parent->is_red_ = false;
+          uncle->is_red_ = false;
+          grand->is_red_ = true;
+          node = grand;
+          continue;
+        }
+        if (node == RightChild(parent)) {
+          RotateLeft(parent);
+          std::swap(node, parent);
         }
-        delete current;
+        parent->is_red_ = false;
+        grand->is_red_ = true;
+        RotateRight(grand);
       } else {
-        Node *iter = current->left_->right_;
-        Node *parent_iter = current->left_;
-        while (!iter->is_right_thread_) {
-          parent_iter = iter;
-          iter = iter->right_;
+        Node *uncle = grand->left_;
+        if (IsRed(uncle)) {
+          parent->is_red_ = false;
+          uncle->is_red_ = false;
+          grand->is_red_ = true;
+          node = grand;
+          continue;
         }
-        if (iter->left_) {
-          parent_iter->right_ = iter->left_;
+        if (node == parent->left_) {
+          RotateRight(parent);
+          std::swap(node, parent);
         }
-        iter->left_ = current->left_;
-        iter->right_ = current->right_;
-        iter->is_right_thread_ = false;
-        parent_iter->is_right_thread_ = true;
-        if (is_right) {
-          parent->right_ = iter;
-        } else {
-          parent->left_ = iter;
+        parent->is_red_ = false;
+        grand->is_red_ = true;
+        RotateLeft(grand);
+      }
+    }
+    root_->left_->is_red_ = false;
+  }
+
+  void EraseNode(Node *node) {
+    Node *parent = node->parent_;
+    // The child that moves up into the removed position (may be null) and
+    // its new parent; the fixup starts there.
+    Node *child = nullptr;
+    Node *child_parent = nullptr;
+    bool removed_red = node->is_red_;
+    if (node->left_ && !node->is_right_thread_) {
+      // Two children: the successor, leftmost in the right subtree, takes
+      // node's place and color.
+      Node *next = Leftmost(node->right_);
+      removed_red = next->is_red_;
+      child = RightChild(next);
+      if (next == node->right_) {
+        child_parent = next;
+      } else {
+        child_parent = next->parent_;
+        child_parent->left_ = child;
+        if (child) {
+          child->parent_ = child_parent;
         }
-        delete current;
+        next->right_ = node->right_;
+        next->is_right_thread_ = false;
+        node->right_->parent_ = next;
       }
+      next->left_ = node->left_;
+      node->left_->parent_ = next;
+      // The predecessor's thread pointed at node; its successor is next now.
+      Rightmost(node->left_)->right_ = next;
+      next->parent_ = parent;
+      ReplaceChild(parent, node, next);
+      next->is_red_ = node->is_red_;
+    } else if (node->left_) {
+      // Only a left child: it moves up, and the predecessor inherits node's
+      // thread.
+      child = node->left_;
+      child_parent = parent;
+      Rightmost(child)->right_ = node->right_;
+      child->parent_ = parent;
+      ReplaceChild(parent, node, child);
+    } else if (!node->is_right_thread_) {
+      // Only a right child; no thread points at node.
+      child = node->right_;
+      child_parent = parent;
+      child->parent_ = parent;
+      ReplaceChild(parent, node, child);
     } else {
-      if (current->left_) {
-        Node *iter = current->left_;
-        while (!iter->is_right_thread_) {
-          iter = iter->right_;
+      // A leaf. As a right child its parent threads to node's successor.
+      child_parent = parent;
+      if (parent->left_ == node) {
+        parent->left_ = nullptr;
+      } else {
+        parent->right_ = node->right_;
+        parent->is_right_thread_ = true;
+      }
+    }
+    delete node;
+    if (!removed_red) {
+      EraseFixup(child, child_parent);
+    }
+  }
+
+  // Restores the black height after a black node left the path through
+  // child. child may be null, so its parent is passed along.
+  void EraseFixup(Node *child, Node *parent) {
+    while (child != root_->left_ && !IsRed(child)) {
+      if (child == parent->left_) {
+        Node *sibling = RightChild(parent);
+        if (IsRed(sibling)) {
+          sibling->is_red_ = false;
+          parent->is_red_ = true;
+          RotateLeft(parent);
+          sibling = RightChild(parent);
+        }
+        if (!IsRed(sibling->left_) && !IsRed(RightChild(sibling))) {
+          sibling->is_red_ = true;
+          child = parent;
+          parent = parent->parent_;
+          continue;
         }
-        iter->right_ = current->right_;
-        if (is_right) {
-          parent->right_ = current->left_;
-        } else {
-          parent->left_ = current->left_;
+        if (!IsRed(RightChild(sibling))) {
+          sibling->left_->is_red_ = false;
+          sibling->is_red_ = true;
+          RotateRight(sibling);
+          sibling = RightChild(parent);
         }
-        delete current;
+        sibling->is_red_ = parent->is_red_;
+        parent->is_red_ = false;
+        RightChild(sibling)->is_red_ = false;
+        RotateLeft(parent);
+        break;
       } else {
-        if (is_right) {
-          parent->right_ = current->right_;
-        } else {
-          parent->left_ = current->right_;
+        Node *sibling = parent->left_;
+        if (IsRed(sibling)) {
+          sibling->is_red_ = false;
+          parent->is_red_ = true;
+          RotateRight(parent);
+          sibling = parent->left_;
+        }
+        if (!IsRed(sibling->left_) && !IsRed(RightChild(sibling))) {
+          sibling->is_red_ = true;
+          child = parent;
+          parent = parent->parent_;
+          continue;
+        }
+        if (!IsRed(sibling->left_)) {
+          RightChild(sibling)->is_red_ = false;
+          sibling->is_red_ = true;
+          RotateLeft(sibling);
+          sibling = parent->left_;
         }
-        delete current;
+        sibling->is_red_ = parent->is_red_;
+        parent->is_red_ = false;
+        sibling->left_->is_red_ = false;
+        RotateRight(parent);
+        break;
       }
     }
+    if (child) {
+      child->is_red_ = false;
+    }
+  }
+
+  // Checks the red-black rules, the parent links, the key order and the
+  // threads of the whole tree. Linear; for tests.
+  bool IsRedBlack() const {
+    if (!root_->is_right_thread_ || root_->right_ != root_ || IsRed(root_)) {
+      return false;
+    }
+    Node *root = root_->left_;
+    return root == nullptr ||
+           (!root->is_red_ && BlackHeight(root, root_) > 0);
+  }
+
+  // Black height of the subtree at node, or -1 if the subtree breaks one of
+  // the rules IsRedBlack checks.
+  int BlackHeight(Node *node, Node *parent) const {
+    if (node == nullptr) {
+      return 1;
+    }
+    if (node->parent_ != parent || (node->is_red_ && parent->is_red_)) {
+      return -1;
+    }
+    Node *right = RightChild(node);
+    if (node->left_ != nullptr &&
+        (!comp_(node->left_->data_.first, node->data_.first) ||
+         Rightmost(node->left_)->right_ != node)) {
+      return -1;
+    }
+    if (right != nullptr && !comp_(node->data_.first, right->data_.first)) {
+      return -1;
+    }
+    int left_height = BlackHeight(node->left_, node);
+    int right_height = BlackHeight(right, node);
+    if (left_height < 0 || left_height != right_height) {
+      return -1;
+    }
+    return left_height + (node->is_red_ ? 0 : 1);
   }
 
   void RecursionClear(Node *iter) {
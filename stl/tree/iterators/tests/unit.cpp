@@ -2,6 +2,7 @@
 #include <future>
 #include <iostream>
 #include <map>
+#include <random>
 #include <string>
 #include <thread>
 #include <cmath>
@@ -12,6 +13,14 @@
 
 #include "../map.hpp"
 
+// Reaches the private invariant check of Map.
+struct MapInspector {
+  template <class M>
+  static bool IsRedBlack(const M& map) {
+    return map.IsRedBlack();
+  }
+};
+
 class MapTest : public testing::Test {
  protected:
   void SetUp() override {
@@ -340,6 +349,96 @@ TEST_F(MapTest, CustomComparator) {
   }
 }
 
+TEST(BalancedMapTest, SortedAndReverseStreams) {
+  const int count = 200000;
+  Map<int, int> sorted;
+  Map<int, int> reverse;
+  for (int i = 0; i < count; ++i) {
+    sorted.Insert({i, i});
+    reverse[count - i] = i;
+  }
+  ASSERT_EQ(sorted.Size(), count);
+  ASSERT_EQ(reverse.Size(), count);
+  ASSERT_TRUE(MapInspector::IsRedBlack(sorted));
+  ASSERT_TRUE(MapInspector::IsRedBlack(reverse));
+  for (int i = 0; i < count; i += 997) {
+    ASSERT_EQ(sorted.Find(i)->second, i);
+    ASSERT_EQ(reverse[count - i], i);
+  }
+  int expected = 0;
+  for (auto it = sorted.Begin(); it != sorted.End(); ++it) {
+    ASSERT_EQ(it->first, expected++);
+  }
+  for (int i = 0; i < count; i += 2) {
+    sorted.Erase(i);
+  }
+  ASSERT_EQ(sorted.Size(), count / 2);
+  ASSERT_TRUE(MapInspector::IsRedBlack(sorted));
+  expected = 1;
+  for (auto it = sorted.Begin(); it != sorted.End(); ++it) {
+    ASSERT_EQ(it->first, expected);
+    expected += 2;
+  }
+}
+
+TEST(BalancedMapTest, PostfixIncrementReturnsOldPosition) {
+  Map<int, int> map;
+  map.Insert({{2, 2}, {1, 1}, {3, 3}, {4, 4}});
+  auto it = map.Begin();
+  auto old = it++;
+  ASSERT_EQ(old->first, 1);
+  ASSERT_EQ(it->first, 2);
+  it++;
+  it++;
+  ASSERT_EQ((it++)->first, 4);
+  ASSERT_EQ(it, map.End());
+}
+
+TEST(BalancedMapTest, RandomAgainstStdMap) {
+  Map<int, int> map;
+  std::map<int, int> model;
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> key_dist(0, 1999);
+  std::uniform_int_distribution<int> op_dist(0, 2);
+  for (int step = 0; step < 100000; ++step) {
+    int key = key_dist(gen);
+    if (op_dist(gen) == 0) {
+      if (model.erase(key) != 0) {
+        map.Erase(key);
+      } else {
+        EXPECT_THROW({ map.Erase(key); }, KeyIsMissingInMap);
+      }
+    } else {
+      map.Insert({key, step});
+      model[key] = step;
+    }
+    ASSERT_EQ(map.Size(), model.size());
+    if (step % 97 == 0) {
+      ASSERT_TRUE(MapInspector::IsRedBlack(map)) << "step " << step;
+    }
+  }
+  ASSERT_TRUE(MapInspector::IsRedBlack(map));
+  auto it = map.Begin();
+  for (const auto& [key, value] : model) {
+    ASSERT_EQ(it->first, key);
+    ASSERT_EQ(it->second, value);
+    ++it;
+  }
+  ASSERT_EQ(it, map.End());
+  auto values = map.Values(false);
+  ASSERT_EQ(values.size(), model.size());
+  ASSERT_EQ(values.front().first, model.rbegin()->first);
+  for (const auto& [key, value] : model) {
+    map.Erase(key);
+    if (key % 7 == 0) {
+      ASSERT_TRUE(MapInspector::IsRedBlack(map));
+    }
+  }
+  ASSERT_TRUE(map.IsEmpty());
+  ASSERT_TRUE(MapInspector::IsRedBlack(map));
+  ASSERT_EQ(map.Begin(), map.End());
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
 
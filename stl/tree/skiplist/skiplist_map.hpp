@@ -0,0 +1,555 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <thread>
+#include <utility>
+
+#include "../../utils/cache_line.hpp"
+#include "exceptions.hpp"
+
+// Tallest tower. With a 1/4 chance of growing each level this covers ~4^16
+// keys before the top level gets crowded.
+const int SKIPLIST_MAX_LEVEL = 16;
+
+// Threads that can be inside the map at once; a Pin held across calls takes
+// one more. Further threads wait for a slot.
+const size_t SKIPLIST_PIN_SLOTS = 64;
+
+// Every this many erases, the erasing thread tries to advance the epoch and
+// frees what it can.
+const size_t SKIPLIST_COLLECT_PERIOD = 64;
+
+// Ordered map on a lock-free skip list (Fraser; Herlihy & Shavit), so any
+// number of threads may Insert, Find, Erase and use operator[] at once.
+//
+// Every level is a sorted singly linked list. The low bit of a next_ word
+// marks the node that owns it as deleted: Erase marks the tower from the top
+// down, and whoever marks level 0 owns the deletion. Traversals in FindWindow
+// unlink marked nodes they pass with CAS and restart if they lose a race;
+// Find only skips them and never writes. A node is in the map once it is
+// linked at level 0; the upper levels are shortcuts added afterwards.
+//
+// Reclamation is epoch based. Every call pins the current epoch in a slot
+// for its duration; an unlinked node is retired with the epoch it was
+// retired in and freed once the epoch has moved two steps past it, which
+// can only happen after every thread pinned at that time has left. A node is
+// retired only once both its inserter (still linking upper levels) and its
+// eraser are done with it, so a late link never outlives the node.
+//
+// Iterators and references into the map stay valid until their key is
+// erased. To keep using them across a concurrent Erase, hold the Guard
+// returned by Pin() for as long as they are used.
+//
+// Unlike Map, Insert does not overwrite an existing value: it returns false
+// and leaves it alone, since another thread may be reading it. Values found
+// through operator[] or an iterator are shared; synchronizing writes to the
+// same value is up to the caller. Iteration is weakly consistent: it sees
+// every key present for the whole walk, and may or may not see concurrent
+// changes.
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class SkipListMap {
+  using Links = std::atomic<uintptr_t> *;
+
+  // The tower of next_ links is allocated right behind the node, so a node
+  // is one allocation; see CreateNode.
+  class Node {
+    friend class SkipListMap;
+
+  private:
+    std::pair<const Key, Value> data_;
+    int height_;
+    // The inserter and the eraser each hold one; see Retire.
+    std::atomic<int> owners_;
+    Links next_;
+    Node *retired_next_;
+    uint64_t retired_epoch_;
+
+    template <class... Args>
+    Node(int height, Args &&...args)
+        : data_(std::forward<Args>(args)...), height_(height), owners_(2),
+          next_(nullptr), retired_next_(nullptr), retired_epoch_(0) {}
+  };
+
+  static_assert(sizeof(Node) % alignof(std::atomic<uintptr_t>) == 0,
+                "the tower follows the node");
+
+  struct alignas(CACHE_LINE) PinSlot {
+    // 0 when free, otherwise the pinned epoch shifted left with the low bit
+    // set.
+    std::atomic<uint64_t> state_{0};
+  };
+
+  static Node *Pointer(uintptr_t word) noexcept {
+    return reinterpret_cast<Node *>(word & ~uintptr_t(1));
+  }
+
+  static bool IsMarked(uintptr_t word) noexcept { return (word & 1) != 0; }
+
+  static uintptr_t Word(Node *node) noexcept {
+    return reinterpret_cast<uintptr_t>(node);
+  }
+
+public:
+  class SkipListIterator {
+  public:
+    // NOLINTNEXTLINE
+    using value_type = std::pair<const Key, Value>;
+    // NOLINTNEXTLINE
+    using reference_type = value_type &;
+    // NOLINTNEXTLINE
+    using pointer_type = value_type *;
+    // NOLINTNEXTLINE
+    using difference_type = std::ptrdiff_t;
+    // NOLINTNEXTLINE
+    using iterator_category = std::forward_iterator_tag;
+
+    inline bool operator==(const SkipListIterator &other) const {
+      return current_ == other.current_;
+    };
+
+    inline bool operator!=(const SkipListIterator &other) const {
+      return current_ != other.current_;
+    };
+
+    inline reference_type operator*() const { return current_->data_; };
+
+    inline pointer_type operator->() const { return &current_->data_; };
+
+    SkipListIterator &operator++() {
+      current_ = SkipDeleted(
+          Pointer(current_->next_[0].load(std::memory_order_acquire)));
+      return *this;
+    };
+
+    SkipListIterator operator++(int) {
+      SkipListIterator tmp(current_);
+      ++(*this);
+      return tmp;
+    };
+
+  private:
+    friend class SkipListMap;
+    explicit SkipListIterator(Node *current) : current_(current) {}
+
+  private:
+    Node *current_;
+  };
+
+  // Keeps every node alive that the pinning thread can reach while it is
+  // held. Pins may nest.
+  class Guard {
+  public:
+    Guard(const Guard &) = delete;
+    Guard &operator=(const Guard &) = delete;
+
+    ~Guard() { slot_->store(0, std::memory_order_release); }
+
+  private:
+    friend class SkipListMap;
+    explicit Guard(const SkipListMap *map) : slot_(map->Enter()) {}
+
+  private:
+    std::atomic<uint64_t> *slot_;
+  };
+
+  SkipListMap() : SkipListMap(Compare()) {}
+
+  explicit SkipListMap(const Compare &comp)
+      : comp_(comp), size_(0), epoch_(0), retired_(nullptr),
+        retired_count_(0) {
+    for (auto &link : head_) {
+      link.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  SkipListMap(const SkipListMap &) = delete;
+  SkipListMap &operator=(const SkipListMap &) = delete;
+
+  // Must not race with any other call.
+  ~SkipListMap() { Clear(); }
+
+  Guard Pin() const { return Guard(this); }
+
+  SkipListIterator Begin() const noexcept {
+    Guard guard(this);
+    return SkipListIterator(
+        SkipDeleted(Pointer(head_[0].load(std::memory_order_acquire))));
+  }
+
+  SkipListIterator End() const noexcept { return SkipListIterator(nullptr); }
+
+  // Snapshot; may be stale by the time it returns.
+  inline size_t Size() const noexcept {
+    return size_.load(std::memory_order_relaxed);
+  }
+
+  inline bool IsEmpty() const noexcept { return Size() == 0; }
+
+  // Inserts val unless the key is present. Returns whether it did.
+  bool Insert(const std::pair<const Key, Value> &val) {
+    Guard guard(this);
+    return InsertNode(val.first, val.second).second;
+  }
+
+  void
+  Insert(const std::initializer_list<std::pair<const Key, Value>> &values) {
+    for (const auto &val : values) {
+      Insert(val);
+    }
+  }
+
+  // Value for key, inserted value-initialized if missing.
+  Value &operator[](const Key &key) {
+    Guard guard(this);
+    return InsertNode(key, Value()).first->data_.second;
+  }
+
+  SkipListIterator Find(const Key &key) const {
+    Guard guard(this);
+    return SkipListIterator(FindNode(key));
+  }
+
+  inline bool Contains(const Key &key) const {
+    Guard guard(this);
+    return FindNode(key) != nullptr;
+  }
+
+  // Throws KeyIsMissingInMap if the key is absent, including when another
+  // thread erases it first.
+  void Erase(const Key &key) {
+    Guard guard(this);
+    Links preds[SKIPLIST_MAX_LEVEL];
+    Node *succs[SKIPLIST_MAX_LEVEL];
+    if (!FindWindow(key, preds, succs)) {
+      throw KeyIsMissingInMap("Value not found");
+    }
+    Node *victim = succs[0];
+    for (int level = victim->height_ - 1; level > 0; --level) {
+      uintptr_t word = victim->next_[level].load(std::memory_order_relaxed);
+      while (!IsMarked(word) &&
+             !victim->next_[level].compare_exchange_weak(
+                 word, word | 1, std::memory_order_acq_rel,
+                 std::memory_order_relaxed)) {
+      }
+    }
+    uintptr_t word = victim->next_[0].load(std::memory_order_relaxed);
+    for (;;) {
+      if (IsMarked(word)) {
+        throw KeyIsMissingInMap("Value not found");
+      }
+      if (victim->next_[0].compare_exchange_weak(word, word | 1,
+                                                 std::memory_order_acq_rel,
+                                                 std::memory_order_relaxed)) {
+        break;
+      }
+    }
+    // Unlinks the victim from every level it is still on.
+    bool last = victim->owners_.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    FindWindow(key, preds, succs);
+    if (last) {
+      Retire(victim);
+    }
+    size_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  // Must not race with any other call or overlap a Pin.
+  void Clear() noexcept {
+    Node *iter = Pointer(head_[0].load(std::memory_order_relaxed));
+    while (iter != nullptr) {
+      uintptr_t next = iter->next_[0].load(std::memory_order_relaxed);
+      // Marked nodes are on the retired list.
+      if (!IsMarked(next)) {
+        DestroyNode(iter);
+      }
+      iter = Pointer(next);
+    }
+    Node *retired = retired_.exchange(nullptr, std::memory_order_acquire);
+    while (retired != nullptr) {
+      Node *next = retired->retired_next_;
+      DestroyNode(retired);
+      retired = next;
+    }
+    for (auto &link : head_) {
+      link.store(0, std::memory_order_relaxed);
+    }
+    size_.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  template <class... Args> static Node *CreateNode(int height, Args &&...args) {
+    void *raw =
+        ::operator new(sizeof(Node) + height * sizeof(std::atomic<uintptr_t>));
+    Node *node;
+    try {
+      node = ::new (raw) Node(height, std::forward<Args>(args)...);
+    } catch (...) {
+      ::operator delete(raw);
+      throw;
+    }
+    node->next_ = reinterpret_cast<Links>(static_cast<char *>(raw) +
+                                          sizeof(Node));
+    for (int level = 0; level < height; ++level) {
+      ::new (static_cast<void *>(node->next_ + level))
+          std::atomic<uintptr_t>(0);
+    }
+    return node;
+  }
+
+  static void DestroyNode(Node *node) noexcept {
+    node->~Node();
+    ::operator delete(static_cast<void *>(node));
+  }
+
+  // Claims a free pin slot and publishes the current epoch in it. The fence
+  // orders the publication before every later read of the links.
+  std::atomic<uint64_t> *Enter() const noexcept {
+    thread_local const size_t start =
+        std::hash<std::thread::id>()(std::this_thread::get_id());
+    for (size_t probe = 0;; ++probe) {
+      std::atomic<uint64_t> &state =
+          pins_[(start + probe) % SKIPLIST_PIN_SLOTS].state_;
+      uint64_t expected = 0;
+      if (state.load(std::memory_order_relaxed) == 0 &&
+          state.compare_exchange_strong(
+              expected, (epoch_.load(std::memory_order_seq_cst) << 1) | 1,
+              std::memory_order_seq_cst)) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return &state;
+      }
+      if (probe % SKIPLIST_PIN_SLOTS == SKIPLIST_PIN_SLOTS - 1) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  bool IsEqual(const Key &a, const Key &b) const {
+    return !comp_(a, b) && !comp_(b, a);
+  }
+
+  static Node *SkipDeleted(Node *node) noexcept {
+    while (node != nullptr) {
+      uintptr_t next = node->next_[0].load(std::memory_order_acquire);
+      if (!IsMarked(next)) {
+        break;
+      }
+      node = Pointer(next);
+    }
+    return node;
+  }
+
+  // Tower height: 1 + the number of pairs of zero bits at the bottom of a
+  // per-thread xorshift word, i.e. each level with probability 1/4.
+  static int RandomLevel() noexcept {
+    thread_local uint64_t state =
+        std::hash<std::thread::id>()(std::this_thread::get_id()) *
+            0x9E3779B97F4A7C15ULL |
+        1;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    int level = 1;
+    for (uint64_t bits = state; (bits & 3) == 0 && level < SKIPLIST_MAX_LEVEL;
+         bits >>= 2) {
+      ++level;
+    }
+    return level;
+  }
+
+  // Fills preds[l] with the links of the last node before key on level l
+  // and succs[l] with the first node not before it, unlinking marked nodes
+  // on the way. Returns whether succs[0] holds key.
+  bool FindWindow(const Key &key, Links *preds, Node **succs) {
+  retry:
+    Links pred = head_;
+    for (int level = SKIPLIST_MAX_LEVEL - 1; level >= 0; --level) {
+      Node *curr = Pointer(pred[level].load(std::memory_order_acquire));
+      while (curr != nullptr) {
+        uintptr_t succ = curr->next_[level].load(std::memory_order_acquire);
+        while (IsMarked(succ)) {
+          uintptr_t expected = Word(curr);
+          if (!pred[level].compare_exchange_strong(
+                  expected, succ & ~uintptr_t(1), std::memory_order_acq_rel,
+                  std::memory_order_acquire)) {
+            goto retry;
+          }
+          curr = Pointer(succ);
+          if (curr == nullptr) {
+            break;
+          }
+          succ = curr->next_[level].load(std::memory_order_acquire);
+        }
+        if (curr == nullptr || !comp_(curr->data_.first, key)) {
+          break;
+        }
+        pred = curr->next_;
+        curr = Pointer(succ);
+      }
+      preds[level] = pred;
+      succs[level] = curr;
+    }
+    return succs[0] != nullptr && IsEqual(succs[0]->data_.first, key);
+  }
+
+  // Read-only search: steps over marked nodes instead of unlinking them.
+  Node *FindNode(const Key &key) const {
+    Links pred = const_cast<Links>(head_);
+    Node *curr = nullptr;
+    for (int level = SKIPLIST_MAX_LEVEL - 1; level >= 0; --level) {
+      curr = Pointer(pred[level].load(std::memory_order_acquire));
+      while (curr != nullptr) {
+        uintptr_t succ = curr->next_[level].load(std::memory_order_acquire);
+        if (IsMarked(succ)) {
+          curr = Pointer(succ);
+          continue;
+        }
+        if (!comp_(curr->data_.first, key)) {
+          break;
+        }
+        pred = curr->next_;
+        curr = Pointer(succ);
+      }
+    }
+    return curr != nullptr && IsEqual(curr->data_.first, key) ? curr : nullptr;
+  }
+
+  // Returns the node holding key and whether this call created it.
+  template <class V>
+  std::pair<Node *, bool> InsertNode(const Key &key, V &&value) {
+    Links preds[SKIPLIST_MAX_LEVEL];
+    Node *succs[SKIPLIST_MAX_LEVEL];
+    Node *node = nullptr;
+    for (;;) {
+      if (FindWindow(key, preds, succs)) {
+        if (node != nullptr) {
+          DestroyNode(node);
+        }
+        return {succs[0], false};
+      }
+      if (node == nullptr) {
+        node = CreateNode(RandomLevel(), key, std::forward<V>(value));
+      }
+      for (int level = 0; level < node->height_; ++level) {
+        node->next_[level].store(Word(succs[level]), std::memory_order_relaxed);
+      }
+      uintptr_t expected = Word(succs[0]);
+      if (preds[0][0].compare_exchange_strong(expected, Word(node),
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed)) {
+        break;
+      }
+    }
+    size_.fetch_add(1, std::memory_order_relaxed);
+    LinkUpperLevels(node, key, preds, succs);
+    if (node->owners_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      // Erased while the upper levels were being linked; the eraser left
+      // the last unlink to us.
+      FindWindow(key, preds, succs);
+      Retire(node);
+    }
+    return {node, true};
+  }
+
+  // Links a node that is already on level 0 into its upper levels. Stops
+  // early once the node is being erased.
+  void LinkUpperLevels(Node *node, const Key &key, Links *preds,
+                       Node **succs) {
+    for (int level = 1; level < node->height_; ++level) {
+      for (;;) {
+        uintptr_t expected = Word(succs[level]);
+        if (preds[level][level].compare_exchange_strong(
+                expected, Word(node), std::memory_order_release,
+                std::memory_order_relaxed)) {
+          break;
+        }
+        // The window moved. Stop if the node is being erased meanwhile,
+        // otherwise aim its link at the new successor and try again.
+        FindWindow(key, preds, succs);
+        if (succs[0] != node) {
+          return;
+        }
+        uintptr_t next = node->next_[level].load(std::memory_order_acquire);
+        if (IsMarked(next) ||
+            (Pointer(next) != succs[level] &&
+             !node->next_[level].compare_exchange_strong(
+                 next, Word(succs[level]), std::memory_order_acq_rel,
+                 std::memory_order_acquire))) {
+          return;
+        }
+      }
+    }
+  }
+
+  // Queues a node that no level links to any more. Called by whichever of
+  // its inserter and eraser lets go of it last.
+  void Retire(Node *node) noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    node->retired_epoch_ = epoch_.load(std::memory_order_seq_cst);
+    PushRetired(node, node);
+    if (retired_count_.fetch_add(1, std::memory_order_relaxed) %
+            SKIPLIST_COLLECT_PERIOD ==
+        SKIPLIST_COLLECT_PERIOD - 1) {
+      Collect();
+    }
+  }
+
+  void PushRetired(Node *first, Node *last) noexcept {
+    Node *head = retired_.load(std::memory_order_relaxed);
+    do {
+      last->retired_next_ = head;
+    } while (!retired_.compare_exchange_weak(head, first,
+                                             std::memory_order_release,
+                                             std::memory_order_relaxed));
+  }
+
+  // Advances the epoch if every pinned thread has seen the current one, then
+  // frees the retired nodes that were retired two or more epochs ago.
+  void Collect() noexcept {
+    uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+    bool quiet = true;
+    for (const auto &pin : pins_) {
+      uint64_t state = pin.state_.load(std::memory_order_seq_cst);
+      if (state != 0 && (state >> 1) != epoch) {
+        quiet = false;
+        break;
+      }
+    }
+    if (quiet && epoch_.compare_exchange_strong(epoch, epoch + 1,
+                                                std::memory_order_seq_cst)) {
+      ++epoch;
+    }
+    Node *node = retired_.exchange(nullptr, std::memory_order_acquire);
+    Node *first = nullptr;
+    Node *last = nullptr;
+    while (node != nullptr) {
+      Node *next = node->retired_next_;
+      if (node->retired_epoch_ + 2 <= epoch) {
+        DestroyNode(node);
+      } else {
+        node->retired_next_ = first;
+        first = node;
+        if (last == nullptr) {
+          last = node;
+        }
+      }
+      node = next;
+    }
+    if (first != nullptr) {
+      PushRetired(first, last);
+    }
+  }
+
+private:
+  Compare comp_;
+  std::atomic<uintptr_t> head_[SKIPLIST_MAX_LEVEL];
+  std::atomic<size_t> size_;
+  std::atomic<uint64_t> epoch_;
+  mutable PinSlot pins_[SKIPLIST_PIN_SLOTS];
+  std::atomic<Node *> retired_;
+  std::atomic<size_t> retired_count_;
+};
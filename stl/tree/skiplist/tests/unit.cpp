@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../skiplist_map.hpp"
+
+TEST(SkipListMapTests, DefaultConstructor) {
+  SkipListMap<int, int> map;
+  ASSERT_TRUE(map.IsEmpty());
+  ASSERT_TRUE(map.Begin() == map.End());
+  ASSERT_TRUE(map.Find(1) == map.End());
+  EXPECT_THROW({ map.Erase(1); }, KeyIsMissingInMap);
+}
+
+TEST(SkipListMapTests, InsertFindErase) {
+  SkipListMap<int, std::string> map;
+  ASSERT_TRUE(map.Insert({2, "two"}));
+  ASSERT_TRUE(map.Insert({1, "one"}));
+  ASSERT_FALSE(map.Insert({2, "deux"}));
+  ASSERT_EQ(map.Size(), 2);
+  ASSERT_EQ(map.Find(2)->second, "two");
+  map[3] = "three";
+  map[2] = "deux";
+  ASSERT_EQ(map.Find(2)->second, "deux");
+  ASSERT_EQ(map.Size(), 3);
+  map.Erase(2);
+  ASSERT_FALSE(map.Contains(2));
+  EXPECT_THROW({ map.Erase(2); }, KeyIsMissingInMap);
+  ASSERT_EQ(map.Size(), 2);
+  ASSERT_TRUE(map.Insert({2, "again"}));
+  ASSERT_EQ(map[2], "again");
+}
+
+TEST(SkipListMapTests, OrderedIteration) {
+  SkipListMap<int, int, std::greater<int>> map;
+  map.Insert({{1, 10}, {5, 50}, {3, 30}, {4, 40}, {2, 20}});
+  std::vector<int> keys;
+  for (auto it = map.Begin(); it != map.End(); it++) {
+    keys.push_back(it->first);
+    ASSERT_EQ((*it).second, it->first * 10);
+  }
+  ASSERT_EQ(keys, (std::vector<int>{5, 4, 3, 2, 1}));
+}
+
+TEST(SkipListMapTests, RandomAgainstModel) {
+  SkipListMap<int, int> map;
+  std::map<int, int> model;
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> key_dist(0, 999);
+  std::uniform_int_distribution<int> op_dist(0, 2);
+  for (int step = 0; step < 50000; ++step) {
+    int key = key_dist(gen);
+    switch (op_dist(gen)) {
+    case 0:
+      ASSERT_EQ(map.Insert({key, step}), model.emplace(key, step).second);
+      break;
+    case 1:
+      if (model.erase(key) != 0) {
+        map.Erase(key);
+      } else {
+        EXPECT_THROW({ map.Erase(key); }, KeyIsMissingInMap);
+      }
+      break;
+    default:
+      ASSERT_EQ(map[key], model[key]);
+    }
+  }
+  ASSERT_EQ(map.Size(), model.size());
+  auto it = map.Begin();
+  for (const auto &[key, value] : model) {
+    ASSERT_EQ(it->first, key);
+    ASSERT_EQ(it->second, value);
+    ++it;
+  }
+  ASSERT_TRUE(it == map.End());
+}
+
+TEST(SkipListMapTests, ConcurrentInsert) {
+  const int threads = 8;
+  const int per_thread = 5000;
+  SkipListMap<int, int> map;
+  std::atomic<int> inserted{0};
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      // Overlapping key ranges so threads race on the same keys.
+      for (int i = 0; i < per_thread; ++i) {
+        int key = (i * threads + t) % (threads * per_thread / 2);
+        if (map.Insert({key, key})) {
+          ++inserted;
+        }
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  ASSERT_EQ(inserted.load(), threads * per_thread / 2);
+  ASSERT_EQ(map.Size(), static_cast<size_t>(threads * per_thread / 2));
+  int expected = 0;
+  for (auto it = map.Begin(); it != map.End(); ++it) {
+    ASSERT_EQ(it->first, expected++);
+  }
+}
+
+TEST(SkipListMapTests, ConcurrentInsertEraseFind) {
+  const int threads = 6;
+  const int keys = 512;
+  SkipListMap<int, int> map;
+  std::atomic<long> balance[keys] = {};
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      std::mt19937 gen(17 + t);
+      std::uniform_int_distribution<int> key_dist(0, keys - 1);
+      std::uniform_int_distribution<int> op_dist(0, 2);
+      for (int step = 0; step < 20000; ++step) {
+        int key = key_dist(gen);
+        switch (op_dist(gen)) {
+        case 0:
+          if (map.Insert({key, key})) {
+            ++balance[key];
+          }
+          break;
+        case 1:
+          try {
+            map.Erase(key);
+            --balance[key];
+          } catch (const KeyIsMissingInMap &) {
+          }
+          break;
+        default: {
+          auto guard = map.Pin();
+          auto it = map.Find(key);
+          if (it != map.End()) {
+            ASSERT_EQ(it->second, key);
+          }
+        }
+        }
+      }
+    });
+  }
+  // A reader walking the list while it changes must see sorted keys.
+  std::thread reader([&] {
+    for (int round = 0; round < 50; ++round) {
+      auto guard = map.Pin();
+      int prev = -1;
+      for (auto it = map.Begin(); it != map.End(); ++it) {
+        ASSERT_LT(prev, it->first);
+        prev = it->first;
+      }
+    }
+  });
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  reader.join();
+  size_t present = 0;
+  for (int key = 0; key < keys; ++key) {
+    ASSERT_TRUE(balance[key] == 0 || balance[key] == 1);
+    ASSERT_EQ(map.Contains(key), balance[key] == 1);
+    present += balance[key];
+  }
+  ASSERT_EQ(map.Size(), present);
+}
+
+// Counts the values alive, i.e. the nodes not yet freed.
+struct Counted {
+  static std::atomic<long> alive;
+
+  Counted() { ++alive; }
+  Counted(const Counted &) { ++alive; }
+  ~Counted() { --alive; }
+};
+
+std::atomic<long> Counted::alive{0};
+
+TEST(SkipListMapTests, ChurnFreesErasedNodes) {
+  SkipListMap<int, Counted> map;
+  for (int round = 0; round < 100000; ++round) {
+    map[round % 100];
+    map.Erase(round % 100);
+  }
+  ASSERT_TRUE(map.IsEmpty());
+  // Only the last few collection periods may still be waiting.
+  ASSERT_LT(Counted::alive.load(),
+            4 * static_cast<long>(SKIPLIST_COLLECT_PERIOD));
+  map.Clear();
+  ASSERT_EQ(Counted::alive.load(), 0);
+}
+
+TEST(SkipListMapTests, ConcurrentChurnFreesErasedNodes) {
+  const int threads = 8;
+  SkipListMap<int, Counted> map;
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      for (int round = 0; round < 20000; ++round) {
+        int key = (round * threads + t) % 256;
+        map[key];
+        try {
+          map.Erase(key);
+        } catch (const KeyIsMissingInMap &) {
+        }
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  // Once the threads are gone, a few more erases let the epoch catch up.
+  for (int round = 0; round < 10 * static_cast<int>(SKIPLIST_COLLECT_PERIOD);
+       ++round) {
+    map[-1];
+    map.Erase(-1);
+  }
+  ASSERT_LT(Counted::alive.load() - static_cast<long>(map.Size()),
+            4 * static_cast<long>(SKIPLIST_COLLECT_PERIOD));
+}
+
+TEST(SkipListMapTests, PinKeepsErasedNodesReadable) {
+  SkipListMap<int, std::string> map;
+  map.Insert({{1, "one"}, {2, "two"}, {3, "three"}});
+  {
+    auto guard = map.Pin();
+    auto it = map.Find(2);
+    map.Erase(2);
+    for (int round = 0; round < 10 * static_cast<int>(SKIPLIST_COLLECT_PERIOD);
+         ++round) {
+      map[100] = "x";
+      map.Erase(100);
+    }
+    ASSERT_EQ(it->second, "two");
+    ++it;
+    ASSERT_EQ(it->first, 3);
+  }
+  ASSERT_FALSE(map.Contains(2));
+  ASSERT_EQ(map.Size(), 2);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstddef>
+
+// Cache line size of the machines we target. Fields written by different
+// threads are aligned to it so that they never share a line.
+const size_t CACHE_LINE = 64;
@@ -34,4 +34,15 @@ public:
 
 private:
   std::string_view error_message_;
-};
\ No newline at end of file
+};
+
+class capacity_exceeded_exception : std::exception {
+public:
+  explicit capacity_exceeded_exception(const std::string &text)
+      : error_message_(text) {}
+
+  const char *what() const noexcept override { return error_message_.data(); }
+
+private:
+  std::string_view error_message_;
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <system_error>
+#include <thread>
+
+// Opt-in switch for the parallel bulk paths of vector. The buffer is split
+// into one contiguous range per worker, so every worker is also the first one
+// to touch its pages and they end up spread across the cores' memory nodes.
+struct parallel_policy {
+  // 0 means std::thread::hardware_concurrency().
+  size_t threads = 0;
+  // Ranges shorter than this are not worth a thread of their own.
+  size_t min_chunk = 1 << 16;
+};
+
+inline size_t parallel_worker_count(size_t count,
+                                    const parallel_policy& policy) {
+  size_t threads = policy.threads;
+  if (threads == 0) {
+    threads = std::thread::hardware_concurrency();
+  }
+  size_t min_chunk = policy.min_chunk == 0 ? 1 : policy.min_chunk;
+  size_t by_size = count / min_chunk;
+  if (threads > by_size) {
+    threads = by_size;
+  }
+  return threads == 0 ? 1 : threads;
+}
+
+// Calls construct(i) for every i in [0, count) on several threads. If any
+// call throws, everything that was constructed is torn down with destroy(i)
+// and the first exception is rethrown, so the caller sees all or nothing.
+template <class Construct, class Destroy>
+void parallel_construct(size_t count, const parallel_policy& policy,
+                        Construct construct, Destroy destroy) {
+  size_t workers = parallel_worker_count(count, policy);
+  std::unique_ptr<std::exception_ptr[]> errors(
+      new std::exception_ptr[workers]);
+  auto run = [&](size_t worker) {
+    size_t first = count * worker / workers;
+    size_t last = count * (worker + 1) / workers;
+    size_t i = first;
+    try {
+      for (; i < last; ++i) {
+        construct(i);
+      }
+    } catch (...) {
+      while (i > first) {
+        destroy(--i);
+      }
+      errors[worker] = std::current_exception();
+    }
+  };
+
+  std::unique_ptr<std::thread[]> threads(new std::thread[workers]);
+  for (size_t worker = 1; worker < workers; ++worker) {
+    try {
+      threads[worker] = std::thread(run, worker);
+    } catch (const std::system_error&) {
+      run(worker);
+    }
+  }
+  run(0);
+  for (size_t worker = 1; worker < workers; ++worker) {
+    if (threads[worker].joinable()) {
+      threads[worker].join();
+    }
+  }
+
+  std::exception_ptr error;
+  for (size_t worker = 0; worker < workers; ++worker) {
+    if (errors[worker] && !error) {
+      error = errors[worker];
+    }
+  }
+  if (!error) {
+    return;
+  }
+  for (size_t worker = 0; worker < workers; ++worker) {
+    if (!errors[worker]) {
+      size_t first = count * worker / workers;
+      size_t last = count * (worker + 1) / workers;
+      for (size_t i = first; i < last; ++i) {
+        destroy(i);
+      }
+    }
+  }
+  std::rethrow_exception(error);
+}
@@ -0,0 +1,285 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "exceptions.hpp"
+
+// Storage for static_vector. Trivial types are kept in a plain array so the
+// whole container stays a literal type and works in constant expressions;
+// everything else lives in raw aligned bytes and is constructed in place.
+template <typename T, size_t N, bool = std::is_trivial<T>::value>
+class static_vector_storage {
+ protected:
+  constexpr static_vector_storage() : data_{}, sz_(0) {}
+
+  constexpr T* ptr() noexcept { return data_; }
+
+  constexpr const T* ptr() const noexcept { return data_; }
+
+  template <class... Args>
+  constexpr void construct(size_t pos, Args&&... args) {
+    data_[pos] = T(std::forward<Args>(args)...);
+  }
+
+  constexpr void destroy(size_t /*pos*/) noexcept {}
+
+  T data_[N == 0 ? 1 : N];
+  size_t sz_;
+};
+
+template <typename T, size_t N>
+class static_vector_storage<T, N, false> {
+ protected:
+  static_vector_storage() : sz_(0) {}
+
+  static_vector_storage(const static_vector_storage& other) : sz_(0) {
+    for (; sz_ < other.sz_; ++sz_) {
+      construct(sz_, other.ptr()[sz_]);
+    }
+  }
+
+  static_vector_storage(static_vector_storage&& other) : sz_(0) {
+    for (; sz_ < other.sz_; ++sz_) {
+      construct(sz_, std::move(other.ptr()[sz_]));
+    }
+  }
+
+  static_vector_storage& operator=(const static_vector_storage& other) {
+    if (this != &other) {
+      destroy_all();
+      for (; sz_ < other.sz_; ++sz_) {
+        construct(sz_, other.ptr()[sz_]);
+      }
+    }
+    return *this;
+  }
+
+  static_vector_storage& operator=(static_vector_storage&& other) {
+    if (this != &other) {
+      destroy_all();
+      for (; sz_ < other.sz_; ++sz_) {
+        construct(sz_, std::move(other.ptr()[sz_]));
+      }
+    }
+    return *this;
+  }
+
+  ~static_vector_storage() { destroy_all(); }
+
+  T* ptr() noexcept { return std::launder(reinterpret_cast<T*>(raw_)); }
+
+  const T* ptr() const noexcept {
+    return std::launder(reinterpret_cast<const T*>(raw_));
+  }
+
+  template <class... Args>
+  void construct(size_t pos, Args&&... args) {
+    ::new (static_cast<void*>(ptr() + pos)) T(std::forward<Args>(args)...);
+  }
+
+  void destroy(size_t pos) noexcept { ptr()[pos].~T(); }
+
+  void destroy_all() noexcept {
+    while (sz_ > 0) {
+      destroy(--sz_);
+    }
+  }
+
+  alignas(T) unsigned char raw_[sizeof(T) * (N == 0 ? 1 : N)];
+  size_t sz_;
+};
+
+// Fixed-capacity vector whose elements live inside the object. It never
+// touches an allocator; going past N throws capacity_exceeded_exception.
+template <typename T, size_t N>
+class static_vector : private static_vector_storage<T, N> {
+  using storage = static_vector_storage<T, N>;
+  using storage::construct;
+  using storage::destroy;
+  using storage::ptr;
+  using storage::sz_;
+
+ public:
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  constexpr static_vector() = default;
+
+  constexpr static_vector(size_t count, const T& value) : storage() {
+    if (count > N) {
+      throw capacity_exceeded_exception("static_vector capacity exceeded");
+    }
+    for (size_t i = 0; i < count; ++i) {
+      this->push_back(value);
+    }
+  }
+
+  constexpr static_vector(std::initializer_list<T> ilist) : storage() {
+    if (ilist.size() > N) {
+      throw capacity_exceeded_exception("static_vector capacity exceeded");
+    }
+    for (const T& val : ilist) {
+      this->push_back(val);
+    }
+  }
+
+  constexpr static_vector& operator=(std::initializer_list<T> ilist) {
+    if (ilist.size() > N) {
+      throw capacity_exceeded_exception("static_vector capacity exceeded");
+    }
+    this->clear();
+    for (const T& val : ilist) {
+      this->push_back(val);
+    }
+    return *this;
+  }
+
+  constexpr T& at(size_t pos) {
+    if (pos >= sz_) {
+      throw invalid_index_exception("Invalid index");
+    }
+    return ptr()[pos];
+  }
+
+  constexpr const T& at(size_t pos) const {
+    if (pos >= sz_) {
+      throw invalid_index_exception("Invalid index");
+    }
+    return ptr()[pos];
+  }
+
+  constexpr T& operator[](size_t pos) { return ptr()[pos]; }
+
+  constexpr const T& operator[](size_t pos) const { return ptr()[pos]; }
+
+  constexpr T& front() {
+    if (sz_ == 0) {
+      throw vector_is_empty_exception("vector is empty");
+    }
+    return ptr()[0];
+  }
+
+  constexpr const T& front() const {
+    if (sz_ == 0) {
+      throw vector_is_empty_exception("vector is empty");
+    }
+    return ptr()[0];
+  }
+
+  constexpr T& back() {
+    if (sz_ == 0) {
+      throw vector_is_empty_exception("vector is empty");
+    }
+    return ptr()[sz_ - 1];
+  }
+
+  constexpr const T& back() const {
+    if (sz_ == 0) {
+      throw vector_is_empty_exception("vector is empty");
+    }
+    return ptr()[sz_ - 1];
+  }
+
+  constexpr iterator begin() noexcept { return ptr(); }
+
+  constexpr const_iterator begin() const noexcept { return ptr(); }
+
+  constexpr iterator end() noexcept { return ptr() + sz_; }
+
+  constexpr const_iterator end() const noexcept { return ptr() + sz_; }
+
+  constexpr T* data() noexcept { return ptr(); }
+
+  constexpr const T* data() const noexcept { return ptr(); }
+
+  constexpr bool is_empty() const noexcept { return sz_ == 0; }
+
+  constexpr bool is_full() const noexcept { return sz_ == N; }
+
+  constexpr size_t size() const noexcept { return sz_; }
+
+  static constexpr size_t capacity() noexcept { return N; }
+
+  // Storage is fixed, so this only validates the request.
+  constexpr void reserve(size_t new_cap) const {
+    if (new_cap > N) {
+      throw capacity_exceeded_exception("static_vector capacity exceeded");
+    }
+  }
+
+  constexpr void clear() noexcept {
+    while (sz_ > 0) {
+      destroy(--sz_);
+    }
+  }
+
+  constexpr void insert(size_t pos, T value) {
+    if (pos > sz_) {
+      throw invalid_index_exception("Invalid index");
+    }
+    if (sz_ == N) {
+      throw capacity_exceeded_exception("static_vector capacity exceeded");
+    }
+    if (pos == sz_) {
+      construct(sz_, std::move(value));
+    } else {
+      T* arr = ptr();
+      construct(sz_, std::move(arr[sz_ - 1]));
+      for (size_t i = sz_ - 1; i > pos; --i) {
+        arr[i] = std::move(arr[i - 1]);
+      }
+      arr[pos] = std::move(value);
+    }
+    ++sz_;
+  }
+
+  constexpr void erase(size_t begin_pos, size_t end_pos) {
+    if (begin_pos >= end_pos || begin_pos > sz_ || end_pos > sz_) {
+      throw invalid_index_exception("Invalid index");
+    }
+    T* arr = ptr();
+    size_t count = end_pos - begin_pos;
+    for (size_t i = end_pos; i < sz_; ++i) {
+      arr[i - count] = std::move(arr[i]);
+    }
+    for (size_t i = 0; i < count; ++i) {
+      destroy(--sz_);
+    }
+  }
+
+  constexpr void push_back(const T& value) { this->emplace_back(value); }
+
+  constexpr void push_back(T&& value) { this->emplace_back(std::move(value)); }
+
+  template <class... Args>
+  constexpr T& emplace_back(Args&&... args) {
+    if (sz_ == N) {
+      throw capacity_exceeded_exception("static_vector capacity exceeded");
+    }
+    construct(sz_, std::forward<Args>(args)...);
+    return ptr()[sz_++];
+  }
+
+  constexpr void pop_back() {
+    if (sz_ == 0) {
+      throw vector_is_empty_exception("You tried to pop from empty vector");
+    }
+    destroy(--sz_);
+  }
+
+  constexpr void resize(size_t count, const T& value) {
+    if (count > N) {
+      throw capacity_exceeded_exception("static_vector capacity exceeded");
+    }
+    while (sz_ < count) {
+      this->push_back(value);
+    }
+    while (sz_ > count) {
+      destroy(--sz_);
+    }
+  }
+};
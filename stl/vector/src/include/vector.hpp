@@ -3,6 +3,8 @@
 #include <initializer_list>
 #include <memory>
 
+#include "parallel.hpp"
+
 const int DEFAULT_CAPACITY = 10;
 
 template <typename T, class allocator = std::allocator<T>>
@@ -89,6 +91,11 @@ class vector {
 
   vector(const vector&);
 
+  // Opt-in parallel fill and copy, see parallel_policy.
+  vector(size_t, const T&, const parallel_policy&);
+
+  vector(const vector&, const parallel_policy&);
+
   vector(vector&&) noexcept;
 
   vector& operator=(const vector&);
@@ -125,6 +132,11 @@ class vector {
 
   void reserve(size_t);
 
+  // Moves the elements into the new buffer on several threads. Elements
+  // whose move may throw are copied instead, so a failure leaves the vector
+  // as it was.
+  void reserve(size_t, const parallel_policy&);
+
   void clear() noexcept;
 
   void insert(size_t, T);
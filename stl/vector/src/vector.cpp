@@ -1,3 +1,5 @@
+#pragma once
+
 #include "vector.hpp"
 #include "exceptions.hpp"
 
@@ -6,6 +8,9 @@ vector<T, allocator>::vector() : arr_(nullptr), sz_(0), cap_(0) {}
 
 template <typename T, class allocator>
 vector<T, allocator>::vector(size_t count, const T& value) : vector() {
+  if (count == 0) {
+    return;
+  }
   cap_ = DEFAULT_CAPACITY;
   while (cap_ < count) {
     cap_ *= 2;
@@ -27,6 +32,53 @@ vector<T, allocator>::vector(const vector& other)
   std::uninitialized_copy(other.arr_, other.arr_ + other.sz_, arr_);
 }
 
+template <typename T, class allocator>
+vector<T, allocator>::vector(size_t count, const T& value,
+                             const parallel_policy& policy)
+    : vector() {
+  if (count == 0) {
+    return;
+  }
+  size_t cap = DEFAULT_CAPACITY;
+  while (cap < count) {
+    cap *= 2;
+  }
+  T* arr = alloc_.allocate(cap);
+  try {
+    parallel_construct(
+        count, policy, [&](size_t i) { alloc_.construct(arr + i, value); },
+        [&](size_t i) { alloc_.destroy(arr + i); });
+  } catch (...) {
+    alloc_.deallocate(arr, cap);
+    throw;
+  }
+  arr_ = arr;
+  sz_ = count;
+  cap_ = cap;
+}
+
+template <typename T, class allocator>
+vector<T, allocator>::vector(const vector& other,
+                             const parallel_policy& policy)
+    : vector() {
+  if (other.cap_ == 0) {
+    return;
+  }
+  T* arr = alloc_.allocate(other.cap_);
+  try {
+    parallel_construct(
+        other.sz_, policy,
+        [&](size_t i) { alloc_.construct(arr + i, other.arr_[i]); },
+        [&](size_t i) { alloc_.destroy(arr + i); });
+  } catch (...) {
+    alloc_.deallocate(arr, other.cap_);
+    throw;
+  }
+  arr_ = arr;
+  sz_ = other.sz_;
+  cap_ = other.cap_;
+}
+
 template <typename T, class allocator>
 vector<T, allocator>::vector(vector&& other) noexcept
     : arr_(other.arr_), sz_(other.sz_), cap_(other.cap_) {
@@ -37,8 +89,7 @@ vector<T, allocator>::vector(vector&& other) noexcept
 
 template <typename T, class allocator>
 vector<T, allocator>::vector(std::initializer_list<T> ilist)
-    : arr_(nullptr), sz_(0), cap_(DEFAULT_CAPACITY) {
-  arr_ = alloc_.allocate(cap_);
+    : arr_(nullptr), sz_(0), cap_(0) {
   for (const T& val : ilist) {
     this->push_back(std::move(val));
   }
@@ -148,6 +199,31 @@ void vector<T, allocator>::reserve(size_t new_cap) {
   cap_ = new_cap;
 }
 
+template <typename T, class allocator>
+void vector<T, allocator>::reserve(size_t new_cap,
+                                   const parallel_policy& policy) {
+  if (new_cap <= cap_) {
+    return;
+  }
+  T* new_arr = alloc_.allocate(new_cap);
+  try {
+    parallel_construct(
+        sz_, policy,
+        [&](size_t i) {
+          alloc_.construct(new_arr + i, std::move_if_noexcept(arr_[i]));
+        },
+        [&](size_t i) { alloc_.destroy(new_arr + i); });
+  } catch (...) {
+    alloc_.deallocate(new_arr, new_cap);
+    throw;
+  }
+  size_t old_sz = sz_;
+  this->clear();
+  sz_ = old_sz;
+  arr_ = new_arr;
+  cap_ = new_cap;
+}
+
 template <typename T, class allocator>
 void vector<T, allocator>::clear() noexcept {
   if (cap_ == 0 || arr_ == nullptr) {
@@ -0,0 +1,130 @@
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "static_vector.hpp"
+
+constexpr static_vector<int, 8> MakeSquares() {
+  static_vector<int, 8> vec;
+  for (int i = 0; i < 5; ++i) {
+    vec.push_back(i * i);
+  }
+  vec.insert(0, -1);
+  vec.erase(1, 2);
+  return vec;
+}
+
+constexpr int Sum(const static_vector<int, 8>& vec) {
+  int sum = 0;
+  for (int value : vec) {
+    sum += value;
+  }
+  return sum;
+}
+
+// Constructors tests
+
+TEST(StaticVectorConstructorsTests, DefaultConstructor) {
+  static_vector<int, 4> vec;
+  ASSERT_EQ(vec.size(), 0);
+  ASSERT_EQ(vec.capacity(), 4);
+  ASSERT_TRUE(vec.is_empty());
+}
+
+TEST(StaticVectorConstructorsTests, SizeConstructor) {
+  static_vector<int, 8> vec(5, 1);
+  ASSERT_EQ(vec.size(), 5);
+  for (size_t i = 0; i < vec.size(); ++i) {
+    ASSERT_EQ(vec[i], 1);
+  }
+  ASSERT_THROW((static_vector<int, 4>(5, 1)), capacity_exceeded_exception);
+}
+
+TEST(StaticVectorConstructorsTests, InitializerListConstructor) {
+  static_vector<int, 8> vec({1, 2, 3, 4, 5});
+  ASSERT_EQ(vec.size(), 5);
+  for (size_t i = 0; i < vec.size(); ++i) {
+    ASSERT_EQ(vec[i], i + 1);
+  }
+}
+
+TEST(StaticVectorConstructorsTests, CopyAndMove) {
+  static_vector<std::string, 4> vec1({"a", "b", "c"});
+  static_vector<std::string, 4> vec2(vec1);
+  ASSERT_EQ(vec2.size(), 3);
+  ASSERT_EQ(vec2[2], "c");
+  static_vector<std::string, 4> vec3(std::move(vec1));
+  ASSERT_EQ(vec3.size(), 3);
+  ASSERT_EQ(vec3[0], "a");
+  vec2 = {"x"};
+  ASSERT_EQ(vec2.size(), 1);
+  vec3 = vec2;
+  ASSERT_EQ(vec3.size(), 1);
+  ASSERT_EQ(vec3[0], "x");
+}
+
+TEST(StaticVectorConstructorsTests, ConstantExpression) {
+  constexpr static_vector<int, 8> vec = MakeSquares();
+  static_assert(vec.size() == 5);
+  static_assert(vec[0] == -1 && vec[1] == 1 && vec[4] == 16);
+  static_assert(Sum(vec) == 29);
+  ASSERT_EQ(vec.back(), 16);
+}
+
+// static_vector tests
+
+TEST(StaticVectorTests, PushBackPastCapacity) {
+  static_vector<int, 2> vec;
+  vec.push_back(1);
+  vec.push_back(2);
+  ASSERT_TRUE(vec.is_full());
+  ASSERT_THROW(vec.push_back(3), capacity_exceeded_exception);
+  ASSERT_EQ(vec.size(), 2);
+}
+
+TEST(StaticVectorTests, InsertErase) {
+  static_vector<std::string, 8> vec({"1", "2", "3"});
+  vec.insert(1, "x");
+  ASSERT_EQ(vec.size(), 4);
+  ASSERT_EQ(vec[1], "x");
+  ASSERT_EQ(vec[3], "3");
+  vec.erase(0, 2);
+  ASSERT_EQ(vec.size(), 2);
+  ASSERT_EQ(vec[0], "2");
+  ASSERT_THROW(vec.insert(5, "y"), invalid_index_exception);
+  ASSERT_THROW(vec.erase(1, 1), invalid_index_exception);
+}
+
+TEST(StaticVectorTests, FrontBackPop) {
+  static_vector<int, 4> vec;
+  ASSERT_THROW(vec.front(), vector_is_empty_exception);
+  ASSERT_THROW(vec.pop_back(), vector_is_empty_exception);
+  vec.emplace_back(3);
+  vec.emplace_back(4);
+  ASSERT_EQ(vec.front(), 3);
+  ASSERT_EQ(vec.back(), 4);
+  vec.pop_back();
+  ASSERT_EQ(vec.back(), 3);
+}
+
+TEST(StaticVectorTests, Resize) {
+  static_vector<int, 8> vec({1, 2, 3, 4, 5});
+  vec.resize(3, 0);
+  ASSERT_EQ(vec.size(), 3);
+  vec.resize(7, 0);
+  ASSERT_EQ(vec.size(), 7);
+  ASSERT_EQ(vec[6], 0);
+  ASSERT_THROW(vec.resize(9, 0), capacity_exceeded_exception);
+  ASSERT_THROW(vec.reserve(9), capacity_exceeded_exception);
+}
+
+TEST(StaticVectorTests, AtOutOfRange) {
+  static_vector<int, 4> vec({1});
+  ASSERT_EQ(vec.at(0), 1);
+  ASSERT_THROW(vec.at(1), invalid_index_exception);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,3 +1,7 @@
+#include <atomic>
+#include <stdexcept>
+#include <string>
+
 #include <gtest/gtest.h>
 
 #include "allocator.hpp"
@@ -397,6 +401,140 @@ TEST(CustomTypeVectorTests, MoveConstructor) {
   ASSERT_EQ(vec2[1].Age(), 25);
 }
 
+// Parallel construction tests
+
+TEST(ParallelVectorTests, SizeConstructor) {
+  parallel_policy policy{4, 1};
+  vector<int, allocator<int>> vec(1000, 7, policy);
+  ASSERT_EQ(vec.size(), 1000);
+  ASSERT_EQ(vec.capacity(), 1280);
+  for (size_t i = 0; i < vec.size(); ++i) {
+    ASSERT_EQ(vec[i], 7);
+  }
+}
+
+TEST(ParallelVectorTests, CopyConstructor) {
+  parallel_policy policy{4, 1};
+  vector<std::string, allocator<std::string>> vec1;
+  for (size_t i = 0; i < 1000; ++i) {
+    vec1.push_back(std::to_string(i));
+  }
+  vector<std::string, allocator<std::string>> vec2(vec1, policy);
+  ASSERT_EQ(vec2.size(), vec1.size());
+  ASSERT_EQ(vec2.capacity(), vec1.capacity());
+  for (size_t i = 0; i < vec1.size(); ++i) {
+    ASSERT_EQ(vec2[i], vec1[i]);
+  }
+}
+
+TEST(ParallelVectorTests, Reserve) {
+  parallel_policy policy{3, 1};
+  vector<std::string, allocator<std::string>> vec;
+  for (size_t i = 0; i < 100; ++i) {
+    vec.push_back(std::to_string(i));
+  }
+  vec.reserve(1000, policy);
+  ASSERT_EQ(vec.capacity(), 1000);
+  ASSERT_EQ(vec.size(), 100);
+  for (size_t i = 0; i < vec.size(); ++i) {
+    ASSERT_EQ(vec[i], std::to_string(i));
+  }
+}
+
+TEST(ParallelVectorTests, SmallInputStaysSerial) {
+  vector<int, allocator<int>> vec(10, 1, parallel_policy{});
+  ASSERT_EQ(vec.size(), 10);
+  ASSERT_EQ(parallel_worker_count(10, parallel_policy{}), 1);
+  ASSERT_EQ(parallel_worker_count(100, parallel_policy{8, 25}), 4);
+}
+
+struct ThrowingCopy {
+  static inline std::atomic<int> live = 0;
+  static inline bool armed = false;
+  int value;
+
+  explicit ThrowingCopy(int v) : value(v) { ++live; }
+  ThrowingCopy(const ThrowingCopy& other) : value(other.value) {
+    if (armed && value == 500) {
+      throw std::runtime_error("copy failed");
+    }
+    ++live;
+  }
+  ~ThrowingCopy() { --live; }
+};
+
+TEST(ParallelVectorTests, CopyRollsBackOnException) {
+  vector<ThrowingCopy, allocator<ThrowingCopy>> vec1;
+  for (int i = 0; i < 1000; ++i) {
+    vec1.emplace_back(i);
+  }
+  ASSERT_EQ(ThrowingCopy::live, 1000);
+  using Vec = vector<ThrowingCopy, allocator<ThrowingCopy>>;
+  ThrowingCopy::armed = true;
+  ASSERT_THROW(Vec(vec1, parallel_policy{4, 1}), std::runtime_error);
+  ThrowingCopy::armed = false;
+  ASSERT_EQ(ThrowingCopy::live, 1000);
+}
+
+// Move may throw and is not noexcept, so reserve has to copy.
+struct ThrowingMove {
+  static inline bool armed = false;
+  std::string value;
+
+  explicit ThrowingMove(int v) : value(std::to_string(v)) {}
+  ThrowingMove(const ThrowingMove& other) = default;
+  ThrowingMove(ThrowingMove&& other) : value(std::move(other.value)) {
+    if (armed) {
+      throw std::runtime_error("move failed");
+    }
+  }
+};
+
+struct ThrowingMoveAndCopy {
+  static inline bool armed = false;
+  std::string value;
+
+  explicit ThrowingMoveAndCopy(int v) : value(std::to_string(v)) {}
+  ThrowingMoveAndCopy(const ThrowingMoveAndCopy& other) : value(other.value) {
+    if (armed && value == "700") {
+      throw std::runtime_error("copy failed");
+    }
+  }
+  ThrowingMoveAndCopy(ThrowingMoveAndCopy&& other)
+      : value(std::move(other.value)) {}
+};
+
+TEST(ParallelVectorTests, ReserveCopiesWhenMoveMayThrow) {
+  vector<ThrowingMove, allocator<ThrowingMove>> vec;
+  for (int i = 0; i < 1000; ++i) {
+    vec.emplace_back(i);
+  }
+  ThrowingMove::armed = true;
+  vec.reserve(5000, parallel_policy{4, 1});
+  ThrowingMove::armed = false;
+  ASSERT_EQ(vec.capacity(), 5000);
+  ASSERT_EQ(vec.size(), 1000);
+  for (size_t i = 0; i < vec.size(); ++i) {
+    ASSERT_EQ(vec[i].value, std::to_string(i));
+  }
+}
+
+TEST(ParallelVectorTests, ReserveLeavesSourceIntactOnException) {
+  vector<ThrowingMoveAndCopy, allocator<ThrowingMoveAndCopy>> vec;
+  for (int i = 0; i < 1000; ++i) {
+    vec.emplace_back(i);
+  }
+  size_t cap = vec.capacity();
+  ThrowingMoveAndCopy::armed = true;
+  ASSERT_THROW(vec.reserve(5000, parallel_policy{4, 1}), std::runtime_error);
+  ThrowingMoveAndCopy::armed = false;
+  ASSERT_EQ(vec.capacity(), cap);
+  ASSERT_EQ(vec.size(), 1000);
+  for (size_t i = 0; i < vec.size(); ++i) {
+    ASSERT_EQ(vec[i].value, std::to_string(i));
+  }
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();